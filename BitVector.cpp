@@ -0,0 +1,264 @@
+#pragma once
+
+#include "Vector.cpp"
+#include "vector_algorithms.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace bit_vector {
+
+// Word kernels. The popcount loop is compiled twice, with and without the
+// POPCNT instruction, and the bulk logic ops get an AVX2 build; the CPU picks
+// at runtime like the kernels in vector_algorithms.h.
+
+inline size_t CountGeneric(const uint64_t *words, size_t n) {
+    size_t total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        total += __builtin_popcountll(words[i]);
+    }
+    return total;
+}
+
+template <typename Op>
+void ApplyGeneric(uint64_t *__restrict to, const uint64_t *__restrict from, size_t n, Op op) {
+    for (size_t i = 0; i < n; ++i) {
+        to[i] = op(to[i], from[i]);
+    }
+}
+
+#ifdef VECTOR_ALGORITHMS_X86
+
+__attribute__((target("popcnt"))) inline size_t CountPopcnt(const uint64_t *words, size_t n) {
+    size_t total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        total += __builtin_popcountll(words[i]);
+    }
+    return total;
+}
+
+inline bool HasPopcnt() {
+    static const bool has_popcnt = __builtin_cpu_supports("popcnt");
+    return has_popcnt;
+}
+
+template <typename Op>
+__attribute__((target("avx2"))) void ApplyAvx2(uint64_t *__restrict to,
+                                               const uint64_t *__restrict from, size_t n, Op op) {
+    for (size_t i = 0; i < n; ++i) {
+        to[i] = op(to[i], from[i]);
+    }
+}
+
+#endif  // VECTOR_ALGORITHMS_X86
+
+inline size_t Count(const uint64_t *words, size_t n) {
+#ifdef VECTOR_ALGORITHMS_X86
+    if (HasPopcnt()) {
+        return CountPopcnt(words, n);
+    }
+#endif
+    return CountGeneric(words, n);
+}
+
+template <typename Op>
+void Apply(uint64_t *to, const uint64_t *from, size_t n, Op op) {
+#ifdef VECTOR_ALGORITHMS_X86
+    if (simd::detail::HasAvx2()) {
+        ApplyAvx2(to, from, n, op);
+        return;
+    }
+#endif
+    ApplyGeneric(to, from, n, op);
+}
+
+struct And {
+    uint64_t operator()(uint64_t a, uint64_t b) const {
+        return a & b;
+    }
+};
+
+struct Or {
+    uint64_t operator()(uint64_t a, uint64_t b) const {
+        return a | b;
+    }
+};
+
+struct Xor {
+    uint64_t operator()(uint64_t a, uint64_t b) const {
+        return a ^ b;
+    }
+};
+
+}  // namespace bit_vector
+
+// Packed vector of bools, 64 per word. Bits past size() in the last word are
+// always zero, so whole-word operations never see garbage.
+class BitVector {
+    static constexpr size_t kWordBits = 64;
+
+    Vector<uint64_t> words_;
+    size_t size_;
+
+    static size_t words_for(size_t bits) {
+        return (bits + kWordBits - 1) / kWordBits;
+    }
+
+    void clear_tail() {
+        if (size_ % kWordBits != 0) {
+            words_[words_.size() - 1] &= (uint64_t(1) << (size_ % kWordBits)) - 1;
+        }
+    }
+
+    // First set bit at or after index.
+    size_t scan(size_t index) const {
+        if (index >= size_) {
+            return size_;
+        }
+        size_t word = index / kWordBits;
+        uint64_t bits = words_[word] & (~uint64_t(0) << (index % kWordBits));
+        while (bits == 0) {
+            if (++word == words_.size()) {
+                return size_;
+            }
+            bits = words_[word];
+        }
+        return word * kWordBits + __builtin_ctzll(bits);
+    }
+
+public:
+    // Stands in for a bool& to one bit.
+    class Reference {
+        uint64_t *word_;
+        uint64_t mask_;
+
+    public:
+        Reference(uint64_t *word, uint64_t mask) : word_(word), mask_(mask) {
+        }
+
+        operator bool() const {
+            return (*word_ & mask_) != 0;
+        }
+
+        Reference& operator=(bool value) {
+            if (value) {
+                *word_ |= mask_;
+            } else {
+                *word_ &= ~mask_;
+            }
+            return *this;
+        }
+
+        Reference& operator=(const Reference &other) {
+            return *this = bool(other);
+        }
+
+        void flip() {
+            *word_ ^= mask_;
+        }
+    };
+
+    explicit BitVector(size_t size = 0, bool value = false) : size_(0) {
+        resize(size, value);
+    }
+
+    void resize(size_t size, bool value = false) {
+        if (size > size_ && value) {
+            if (size_ % kWordBits != 0) {
+                words_[words_.size() - 1] |= ~uint64_t(0) << (size_ % kWordBits);
+            }
+            words_.resize(words_for(size), ~uint64_t(0));
+        } else {
+            words_.resize(words_for(size), 0);
+        }
+        size_ = size;
+        clear_tail();
+    }
+
+    void push_back(bool value) {
+        if (size_ % kWordBits == 0) {
+            words_.push_back(0);
+        }
+        words_[size_ / kWordBits] |= uint64_t(value) << (size_ % kWordBits);
+        ++size_;
+    }
+
+    void pop_back() {
+        resize(size_ - 1);
+    }
+
+    void clear() {
+        words_.clear();
+        size_ = 0;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool operator[](size_t index) const {
+        return (words_[index / kWordBits] >> (index % kWordBits)) & 1;
+    }
+
+    Reference operator[](size_t index) {
+        return Reference(&words_[index / kWordBits], uint64_t(1) << (index % kWordBits));
+    }
+
+    // Number of set bits.
+    size_t count() const {
+        return bit_vector::Count(words_.begin(), words_.size());
+    }
+
+    // Index of the first set bit, or size() if there is none.
+    size_t find_first() const {
+        return scan(0);
+    }
+
+    // Index of the first set bit after index, or size() if there is none.
+    size_t find_next(size_t index) const {
+        return scan(index + 1);
+    }
+
+    void flip() {
+        for (size_t i = 0; i < words_.size(); ++i) {
+            words_[i] = ~words_[i];
+        }
+        clear_tail();
+    }
+
+    // Bulk logic ops work word by word and need vectors of equal size. The
+    // kernels take non-aliasing words, so self-assignment is handled here.
+    BitVector& operator&=(const BitVector &other) {
+        assert(size_ == other.size_);
+        if (&other == this) {
+            return *this;
+        }
+        bit_vector::Apply(words_.begin(), other.words_.begin(), words_.size(), bit_vector::And());
+        return *this;
+    }
+
+    BitVector& operator|=(const BitVector &other) {
+        assert(size_ == other.size_);
+        if (&other == this) {
+            return *this;
+        }
+        bit_vector::Apply(words_.begin(), other.words_.begin(), words_.size(), bit_vector::Or());
+        return *this;
+    }
+
+    BitVector& operator^=(const BitVector &other) {
+        assert(size_ == other.size_);
+        if (&other == this) {
+            std::fill(words_.begin(), words_.end(), 0);
+            return *this;
+        }
+        bit_vector::Apply(words_.begin(), other.words_.begin(), words_.size(), bit_vector::Xor());
+        return *this;
+    }
+
+    // Raw words, least significant bit first.
+    const uint64_t* data() const {
+        return words_.begin();
+    }
+};
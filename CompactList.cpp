@@ -0,0 +1,296 @@
+#pragma once
+
+#include "Vector.cpp"
+#include "relocation.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Doubly linked list whose nodes live in one Vector and link by 32-bit
+// indices, so links cost 8 bytes per element instead of 16 and neighbouring
+// nodes tend to share cache lines. Node 0 is a sentinel closing the ring, and
+// erased nodes go on a free list threaded through their next links.
+//
+// Indices stay valid when the Vector moves, so the whole list relocates as
+// raw bytes; for trivially copyable T a copy is one copy of the node array.
+// That is also why T must be trivially relocatable.
+template <typename T>
+class CompactList {
+    static_assert(IsTriviallyRelocatableV<T>, "nodes are moved as raw bytes");
+
+    static constexpr uint32_t kSentinel = 0;
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct Node {
+        alignas(T) unsigned char storage[sizeof(T)];
+        uint32_t prev, next;
+
+        T& value() {
+            return *reinterpret_cast<T*>(storage);
+        }
+
+        const T& value() const {
+            return *reinterpret_cast<const T*>(storage);
+        }
+    };
+
+    Vector<Node> nodes_;
+    uint32_t free_;
+    size_t size_;
+
+    // Takes a node off the free list or appends one; its value is unset.
+    uint32_t allocate_node() {
+        if (free_ != kNone) {
+            uint32_t index = free_;
+            free_ = nodes_[index].next;
+            return index;
+        }
+        if (nodes_.size() == kNone) {
+            throw std::length_error("CompactList: too many nodes");
+        }
+        nodes_.emplace_back();
+        return nodes_.size() - 1;
+    }
+
+    void free_node(uint32_t index) {
+        nodes_[index].next = free_;
+        free_ = index;
+    }
+
+    template <typename... Args>
+    uint32_t construct_node(Args&&... args) {
+        uint32_t index = allocate_node();
+        try {
+            new (nodes_[index].storage) T(std::forward<Args>(args)...);
+        } catch (...) {
+            free_node(index);
+            throw;
+        }
+        return index;
+    }
+
+    template <typename... Args>
+    uint32_t link_before(uint32_t position, Args&&... args) {
+        uint32_t index;
+        if (free_ == kNone && nodes_.size() == nodes_.capacity()) {
+            // args may point into nodes_, which is about to move.
+            T value(std::forward<Args>(args)...);
+            index = construct_node(std::move(value));
+        } else {
+            index = construct_node(std::forward<Args>(args)...);
+        }
+        Node &node = nodes_[index];
+        node.next = position;
+        node.prev = nodes_[position].prev;
+        nodes_[node.prev].next = index;
+        nodes_[position].prev = index;
+        ++size_;
+        return index;
+    }
+
+    void unlink(uint32_t index) {
+        Node &node = nodes_[index];
+        nodes_[node.prev].next = node.next;
+        nodes_[node.next].prev = node.prev;
+        std::destroy_at(&node.value());
+        free_node(index);
+        --size_;
+    }
+
+    template <bool Const>
+    class Iterator {
+        using Value = std::conditional_t<Const, const T, T>;
+        using Owner = std::conditional_t<Const, const CompactList, CompactList>;
+
+        Owner* list_;
+        uint32_t index_;
+
+        friend class CompactList;
+
+    public:
+        Iterator(Owner* list, uint32_t index) : list_(list), index_(index) {
+        }
+
+        operator Iterator<true>() const {
+            return Iterator<true>(list_, index_);
+        }
+
+        Iterator& operator++() {
+            index_ = list_->nodes_[index_].next;
+            return *this;
+        }
+
+        Iterator& operator--() {
+            index_ = list_->nodes_[index_].prev;
+            return *this;
+        }
+
+        Value& operator*() const {
+            return list_->nodes_[index_].value();
+        }
+
+        Value* operator->() const {
+            return &list_->nodes_[index_].value();
+        }
+
+        bool operator==(const Iterator &rhs) const {
+            return index_ == rhs.index_;
+        }
+
+        bool operator!=(const Iterator &rhs) const {
+            return index_ != rhs.index_;
+        }
+    };
+
+public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    CompactList() : free_(kNone), size_(0) {
+        nodes_.emplace_back();
+        nodes_[kSentinel].prev = nodes_[kSentinel].next = kSentinel;
+    }
+
+    CompactList(const CompactList &list) : CompactList() {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            nodes_ = list.nodes_;
+            free_ = list.free_;
+            size_ = list.size_;
+        } else {
+            nodes_.reserve(list.size_ + 1);
+            for (const T &value : list) {
+                push_back(value);
+            }
+        }
+    }
+
+    CompactList& operator=(const CompactList &list) {
+        if (&list == this) {
+            return *this;
+        }
+        CompactList copy(list);
+        swap(copy);
+        return *this;
+    }
+
+    ~CompactList() {
+        clear();
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        return nodes_[link_before(kSentinel, std::forward<Args>(args)...)].value();
+    }
+
+    template <typename... Args>
+    T& emplace_front(Args&&... args) {
+        return nodes_[link_before(nodes_[kSentinel].next, std::forward<Args>(args)...)].value();
+    }
+
+    void push_back(const T &value) {
+        emplace_back(value);
+    }
+
+    void push_back(T &&value) {
+        emplace_back(std::move(value));
+    }
+
+    void push_front(const T &value) {
+        emplace_front(value);
+    }
+
+    void push_front(T &&value) {
+        emplace_front(std::move(value));
+    }
+
+    void pop_back() {
+        unlink(nodes_[kSentinel].prev);
+    }
+
+    void pop_front() {
+        unlink(nodes_[kSentinel].next);
+    }
+
+    // Inserts before position and returns an iterator to the new element.
+    template <typename... Args>
+    iterator emplace(const_iterator position, Args&&... args) {
+        return iterator(this, link_before(position.index_, std::forward<Args>(args)...));
+    }
+
+    iterator insert(const_iterator position, const T &value) {
+        return emplace(position, value);
+    }
+
+    iterator insert(const_iterator position, T &&value) {
+        return emplace(position, std::move(value));
+    }
+
+    iterator erase(const_iterator position) {
+        uint32_t next = nodes_[position.index_].next;
+        unlink(position.index_);
+        return iterator(this, next);
+    }
+
+    // Also gives the node array back, leaving just the sentinel.
+    void clear() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (uint32_t i = nodes_[kSentinel].next; i != kSentinel; i = nodes_[i].next) {
+                std::destroy_at(&nodes_[i].value());
+            }
+        }
+        nodes_.resize(1);
+        nodes_.shrink_to_fit();
+        nodes_[kSentinel].prev = nodes_[kSentinel].next = kSentinel;
+        free_ = kNone;
+        size_ = 0;
+    }
+
+    void swap(CompactList &list) {
+        nodes_.swap(list.nodes_);
+        std::swap(free_, list.free_);
+        std::swap(size_, list.size_);
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    T& front() {
+        return nodes_[nodes_[kSentinel].next].value();
+    }
+
+    const T& front() const {
+        return nodes_[nodes_[kSentinel].next].value();
+    }
+
+    T& back() {
+        return nodes_[nodes_[kSentinel].prev].value();
+    }
+
+    const T& back() const {
+        return nodes_[nodes_[kSentinel].prev].value();
+    }
+
+    iterator begin() {
+        return iterator(this, nodes_[kSentinel].next);
+    }
+
+    const_iterator begin() const {
+        return const_iterator(this, nodes_[kSentinel].next);
+    }
+
+    iterator end() {
+        return iterator(this, kSentinel);
+    }
+
+    const_iterator end() const {
+        return const_iterator(this, kSentinel);
+    }
+};
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "hazard_pointers.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Unbounded lock-free FIFO for many producers and many consumers, after
+// Michael and Scott. The list always starts with a dummy node; push_back
+// links a node after the tail, pop_front swings the head to the first real
+// node, moves its value out and makes it the new dummy. Nodes unlinked from
+// the head are freed through HazardPointers once no thread is reading them.
+//
+// Mirrors List's push_back/pop_front, except that pop_front hands the value
+// back and reports an empty queue instead of requiring one to be non-empty.
+template <typename T>
+class ConcurrentQueue {
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() {
+            return reinterpret_cast<T*>(storage);
+        }
+
+        static void Delete(void *node) {
+            delete static_cast<Node*>(node);
+        }
+    };
+
+    // Producers hammer tail and consumers head; keep them off one cache line.
+    alignas(64) std::atomic<Node*> head;
+    alignas(64) std::atomic<Node*> tail;
+
+    void link(Node *node);
+
+public:
+    ConcurrentQueue();
+    ConcurrentQueue(const ConcurrentQueue&) = delete;
+    ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+    void push_back(const T &value);
+    void push_back(T &&value);
+    template <typename... Args>
+    void emplace_back(Args&&... args);
+    bool pop_front(T &value);
+    bool empty() const;
+    ~ConcurrentQueue();
+};
+
+template <typename T>
+ConcurrentQueue<T>::ConcurrentQueue() {
+    Node *dummy = new Node;
+    head.store(dummy, std::memory_order_relaxed);
+    tail.store(dummy, std::memory_order_relaxed);
+}
+
+template <typename T>
+void ConcurrentQueue<T>::push_back(const T &value) {
+    emplace_back(value);
+}
+
+template <typename T>
+void ConcurrentQueue<T>::push_back(T &&value) {
+    emplace_back(std::move(value));
+}
+
+template <typename T>
+template <typename... Args>
+void ConcurrentQueue<T>::emplace_back(Args&&... args) {
+    std::unique_ptr<Node> node(new Node);
+    new (node->storage) T(std::forward<Args>(args)...);
+    link(node.release());
+}
+
+// Appends node after the tail. A tail left behind by a stalled producer is
+// swung forward by whoever finds it, so no thread waits on another.
+template <typename T>
+void ConcurrentQueue<T>::link(Node *node) {
+    while (true) {
+        Node *last = HazardPointers::Protect(0, tail);
+        Node *next = last->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            tail.compare_exchange_weak(last, next, std::memory_order_release,
+                                       std::memory_order_relaxed);
+            continue;
+        }
+        if (last->next.compare_exchange_weak(next, node, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+            tail.compare_exchange_strong(last, node, std::memory_order_release,
+                                         std::memory_order_relaxed);
+            break;
+        }
+    }
+    HazardPointers::Clear(0);
+}
+
+// Moves the front element into value and removes it; false if the queue was
+// empty. The move assignment must not throw.
+template <typename T>
+bool ConcurrentQueue<T>::pop_front(T &value) {
+    Node *first;
+    Node *next;
+    while (true) {
+        first = HazardPointers::Protect(0, head);
+        next = HazardPointers::Protect(1, first->next);
+        if (head.load(std::memory_order_acquire) != first) {
+            continue;
+        }
+        if (next == nullptr) {
+            HazardPointers::Clear(0);
+            HazardPointers::Clear(1);
+            return false;
+        }
+        // Never let head pass tail, or tail could point at a freed node.
+        Node *last = tail.load(std::memory_order_acquire);
+        if (first == last) {
+            tail.compare_exchange_weak(last, next, std::memory_order_release,
+                                       std::memory_order_relaxed);
+            continue;
+        }
+        if (head.compare_exchange_weak(first, next, std::memory_order_acq_rel,
+                                       std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    // Only the winner of the head swing touches next's value; next is the
+    // dummy now and its storage stays unused until it is freed.
+    value = std::move(*next->value());
+    std::destroy_at(next->value());
+    HazardPointers::Clear(0);
+    HazardPointers::Clear(1);
+    HazardPointers::Retire(first, &Node::Delete);
+    return true;
+}
+
+// A snapshot; other threads may change the answer at once.
+template <typename T>
+bool ConcurrentQueue<T>::empty() const {
+    Node *first = HazardPointers::Protect(0, head);
+    bool result = first->next.load(std::memory_order_acquire) == nullptr;
+    HazardPointers::Clear(0);
+    return result;
+}
+
+// No other thread may be using the queue.
+template <typename T>
+ConcurrentQueue<T>::~ConcurrentQueue() {
+    Node *node = head.load(std::memory_order_acquire);
+    Node *next = node->next.load(std::memory_order_acquire);
+    delete node;
+    while (next != nullptr) {
+        node = next;
+        next = node->next.load(std::memory_order_relaxed);
+        std::destroy_at(node->value());
+        delete node;
+    }
+}
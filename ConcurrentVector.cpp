@@ -0,0 +1,184 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Append-only vector for many writers. Elements live in segments of
+// geometrically growing size (kFirstSegment, 2 * kFirstSegment, ...) that are
+// never moved or freed before destruction, so element addresses are stable.
+// push_back claims a slot with one atomic compare-and-swap; a segment is
+// allocated by whichever thread needs it first, losers of that race free
+// their copy.
+//
+// Element i may be read by any thread once the push_back that returned i has
+// completed and the reader is synchronized with it (e.g. by a join, a queue,
+// or an atomic flag). size() counts claimed slots, including ones still being
+// written.
+template <typename T, typename Alloc = std::allocator<T>>
+class ConcurrentVector {
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    static constexpr size_t kFirstShift = 3;
+    static constexpr size_t kFirstSegment = size_t(1) << kFirstShift;
+    static constexpr size_t kMaxSegments = 64 - kFirstShift;
+
+    std::atomic<T*> segments[kMaxSegments];
+    std::atomic<size_t> count;
+    Alloc allocator;
+
+    static size_t segment_of(size_t index);
+    static size_t segment_size(size_t segment);
+    static size_t segment_start(size_t segment);
+    T* segment(size_t segment);
+    size_t claim();
+
+public:
+    using allocator_type = Alloc;
+
+    ConcurrentVector(const Alloc &allocator = Alloc());
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+    void reserve(size_t size);
+    size_t push_back(const T &value);
+    size_t push_back(T &&value);
+    template <typename... Args>
+    size_t emplace_back(Args&&... args);
+    size_t size() const;
+    T& operator[](size_t index);
+    const T& operator[](size_t index) const;
+    ~ConcurrentVector();
+};
+
+template <typename T, typename Alloc>
+size_t ConcurrentVector<T, Alloc>::segment_of(size_t index) {
+    size_t shifted = (index >> kFirstShift) + 1;
+    return 63 - __builtin_clzll(shifted);
+}
+
+template <typename T, typename Alloc>
+size_t ConcurrentVector<T, Alloc>::segment_size(size_t segment) {
+    return kFirstSegment << segment;
+}
+
+template <typename T, typename Alloc>
+size_t ConcurrentVector<T, Alloc>::segment_start(size_t segment) {
+    return (kFirstSegment << segment) - kFirstSegment;
+}
+
+// Returns the segment, allocating it if no thread has yet.
+template <typename T, typename Alloc>
+T* ConcurrentVector<T, Alloc>::segment(size_t segment) {
+    T *current = segments[segment].load(std::memory_order_acquire);
+    if (current != nullptr) {
+        return current;
+    }
+    Alloc local(allocator);
+    T *fresh = AllocTraits::allocate(local, segment_size(segment));
+    if (segments[segment].compare_exchange_strong(current, fresh, std::memory_order_acq_rel,
+                                                  std::memory_order_acquire)) {
+        return fresh;
+    }
+    AllocTraits::deallocate(local, fresh, segment_size(segment));
+    return current;
+}
+
+template <typename T, typename Alloc>
+ConcurrentVector<T, Alloc>::ConcurrentVector(const Alloc &allocator)
+    : count(0), allocator(allocator) {
+    for (auto &segment : segments) {
+        segment.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+// Allocates the segments for the first size elements up front, so writers
+// never race to allocate them.
+template <typename T, typename Alloc>
+void ConcurrentVector<T, Alloc>::reserve(size_t size) {
+    if (size == 0) {
+        return;
+    }
+    for (size_t i = 0; i <= segment_of(size - 1); ++i) {
+        segment(i);
+    }
+}
+
+template <typename T, typename Alloc>
+size_t ConcurrentVector<T, Alloc>::push_back(const T &value) {
+    return emplace_back(value);
+}
+
+template <typename T, typename Alloc>
+size_t ConcurrentVector<T, Alloc>::push_back(T &&value) {
+    return emplace_back(std::move(value));
+}
+
+// Takes the next slot once its segment exists, so a failed allocation leaves
+// no claimed slot behind for the destructor to destroy.
+template <typename T, typename Alloc>
+size_t ConcurrentVector<T, Alloc>::claim() {
+    size_t index = count.load(std::memory_order_relaxed);
+    do {
+        segment(segment_of(index));
+    } while (!count.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+    return index;
+}
+
+// Returns the index of the new element. Nothing may throw once the slot is
+// claimed, so an element whose constructor can throw is built first and then
+// moved in.
+template <typename T, typename Alloc>
+template <typename... Args>
+size_t ConcurrentVector<T, Alloc>::emplace_back(Args&&... args) {
+    if constexpr (std::is_nothrow_constructible_v<T, Args&&...>) {
+        size_t index = claim();
+        size_t k = segment_of(index);
+        new (segment(k) + (index - segment_start(k))) T(std::forward<Args>(args)...);
+        return index;
+    } else {
+        static_assert(std::is_nothrow_move_constructible_v<T>,
+                      "ConcurrentVector needs nothrow construction or a nothrow move");
+        T value(std::forward<Args>(args)...);
+        size_t index = claim();
+        size_t k = segment_of(index);
+        new (segment(k) + (index - segment_start(k))) T(std::move(value));
+        return index;
+    }
+}
+
+template <typename T, typename Alloc>
+size_t ConcurrentVector<T, Alloc>::size() const {
+    return count.load(std::memory_order_acquire);
+}
+
+template <typename T, typename Alloc>
+T& ConcurrentVector<T, Alloc>::operator[](size_t index) {
+    size_t k = segment_of(index);
+    return segments[k].load(std::memory_order_acquire)[index - segment_start(k)];
+}
+
+template <typename T, typename Alloc>
+const T& ConcurrentVector<T, Alloc>::operator[](size_t index) const {
+    size_t k = segment_of(index);
+    return segments[k].load(std::memory_order_acquire)[index - segment_start(k)];
+}
+
+// All writers must have finished.
+template <typename T, typename Alloc>
+ConcurrentVector<T, Alloc>::~ConcurrentVector() {
+    size_t total = count.load(std::memory_order_acquire);
+    for (size_t k = 0; k < kMaxSegments; ++k) {
+        T *data = segments[k].load(std::memory_order_acquire);
+        if (data == nullptr) {
+            continue;
+        }
+        size_t start = segment_start(k);
+        if (start < total) {
+            size_t live = total - start;
+            std::destroy_n(data, live < segment_size(k) ? live : segment_size(k));
+        }
+        AllocTraits::deallocate(allocator, data, segment_size(k));
+    }
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "Vector.cpp"
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// Copy-on-write Vector. Copies share one reference-counted buffer, so handing
+// a snapshot to another thread is O(1); the first mutation through a shared
+// copy duplicates the elements and leaves the other copies untouched.
+//
+// Reads hand out const references only. Mutations go through the methods
+// below or through mutable_vector(), and invalidate references taken earlier
+// from this copy.
+template <typename T>
+class CowVector {
+    // Like SharedPtr's ControlBlockHolder, but the counter is atomic because
+    // snapshots are released from whichever thread held them last.
+    struct Block {
+        std::atomic<size_t> ref_counter_{1};
+        Vector<T> values_;
+
+        template <typename... Args>
+        explicit Block(Args&&... args) : values_(std::forward<Args>(args)...) {
+        }
+    };
+
+    Block *block_;  // nullptr while empty and unshared
+
+    void release() {
+        if (block_ != nullptr && block_->ref_counter_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete block_;
+        }
+        block_ = nullptr;
+    }
+
+    // Makes this copy the only owner of its buffer.
+    Vector<T>& detach() {
+        if (block_ == nullptr) {
+            block_ = new Block();
+        } else if (block_->ref_counter_.load(std::memory_order_acquire) != 1) {
+            Block *copy = new Block(block_->values_);
+            release();
+            block_ = copy;
+        }
+        return block_->values_;
+    }
+
+public:
+    CowVector() : block_(nullptr) {
+    }
+
+    explicit CowVector(size_t size, const T &value = T()) : block_(new Block(size, value)) {
+    }
+
+    explicit CowVector(Vector<T> values) : block_(new Block()) {
+        block_->values_.swap(values);
+    }
+
+    CowVector(const CowVector &vector) : block_(vector.block_) {
+        if (block_ != nullptr) {
+            block_->ref_counter_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CowVector(CowVector &&vector) : block_(vector.block_) {
+        vector.block_ = nullptr;
+    }
+
+    CowVector& operator=(const CowVector &vector) {
+        CowVector copy(vector);
+        swap(copy);
+        return *this;
+    }
+
+    CowVector& operator=(CowVector &&vector) {
+        CowVector moved(std::move(vector));
+        swap(moved);
+        return *this;
+    }
+
+    ~CowVector() {
+        release();
+    }
+
+    void swap(CowVector &vector) {
+        std::swap(block_, vector.block_);
+    }
+
+    size_t size() const {
+        return block_ != nullptr ? block_->values_.size() : 0;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    // Number of copies sharing the buffer, 0 for an empty default copy.
+    size_t use_count() const {
+        return block_ != nullptr ? block_->ref_counter_.load(std::memory_order_relaxed) : 0;
+    }
+
+    const T* begin() const {
+        return block_ != nullptr ? block_->values_.begin() : nullptr;
+    }
+
+    const T* end() const {
+        return block_ != nullptr ? block_->values_.end() : nullptr;
+    }
+
+    const T& operator[](size_t index) const {
+        return block_->values_[index];
+    }
+
+    // Unshared storage for arbitrary edits; valid until this copy is copied
+    // from or changed through another method.
+    Vector<T>& mutable_vector() {
+        return detach();
+    }
+
+    void set(size_t index, const T &value) {
+        detach()[index] = value;
+    }
+
+    void push_back(const T &value) {
+        detach().push_back(value);
+    }
+
+    void push_back(T &&value) {
+        detach().push_back(std::move(value));
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        return detach().emplace_back(std::forward<Args>(args)...);
+    }
+
+    void pop_back() {
+        detach().pop_back();
+    }
+
+    void resize(size_t size) {
+        detach().resize(size);
+    }
+
+    // Drops this copy's reference instead of clearing shared storage.
+    void clear() {
+        release();
+    }
+};
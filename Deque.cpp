@@ -0,0 +1,297 @@
+#pragma once
+
+#include "Vector.cpp"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Double-ended queue of fixed-size chunks. A Vector of chunk pointers maps
+// positions to chunks; growing only reallocates that map, so elements never
+// move and references stay valid until the element is removed. The chunk
+// holding the end position is always allocated, so iterators can step into
+// it without checks.
+//
+// Only the chunks holding elements, plus that end chunk, stay allocated. A
+// chunk emptied at either end is kept as a spare for the next one needed, so
+// a queue drained at the front while it grows at the back stops allocating;
+// further chunks go back to the allocator. When the live chunks reach an end
+// of the map they are moved back to its middle, and the map only grows once
+// they fill half of it.
+template <typename T>
+class Deque {
+    static constexpr size_t kChunkSize = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+
+    Vector<T*> map_;
+    T* spare_;      // an unused chunk, or nullptr
+    size_t front_;  // position of the first element, counted from map_[0]
+    size_t size_;
+
+    T* slot(size_t position) const {
+        return map_[position / kChunkSize] + position % kChunkSize;
+    }
+
+    // Allocates the chunk unless it already is; it must lie inside the map.
+    void ensure_chunk(size_t chunk) {
+        if (map_[chunk] == nullptr) {
+            if (spare_ != nullptr) {
+                map_[chunk] = spare_;
+                spare_ = nullptr;
+            } else {
+                map_[chunk] = std::allocator<T>().allocate(kChunkSize);
+            }
+        }
+    }
+
+    // Takes back a chunk no position uses any more.
+    void release_chunk(size_t chunk) {
+        if (spare_ == nullptr) {
+            spare_ = map_[chunk];
+        } else {
+            std::allocator<T>().deallocate(map_[chunk], kChunkSize);
+        }
+        map_[chunk] = nullptr;
+    }
+
+    // Moves the live chunks to the middle of the map, growing it first when
+    // they fill more than half of it, so both ends get free chunk slots.
+    void recentre() {
+        size_t first = front_ / kChunkSize;
+        size_t used = (front_ + size_) / kChunkSize - first + 1;
+        size_t size = std::max(map_.size(), 2 * used + 2);
+        size_t target = (size - used) / 2;
+        Vector<T*> map(size, nullptr);
+        for (size_t i = 0; i < used; ++i) {
+            map[target + i] = map_[first + i];
+        }
+        map_.swap(map);
+        front_ = front_ - first * kChunkSize + target * kChunkSize;
+    }
+
+    // An empty deque starts over at the beginning of its one chunk.
+    void rewind_if_empty() {
+        if (size_ == 0) {
+            front_ -= front_ % kChunkSize;
+        }
+    }
+
+    template <bool Const>
+    class Iterator {
+        using Value = std::conditional_t<Const, const T, T>;
+
+        T* const* chunk_;
+        Value* current_;
+
+    public:
+        Iterator(T* const* chunk, Value* current) : chunk_(chunk), current_(current) {
+        }
+
+        operator Iterator<true>() const {
+            return Iterator<true>(chunk_, current_);
+        }
+
+        Iterator& operator++() {
+            if (++current_ == *chunk_ + kChunkSize) {
+                ++chunk_;
+                current_ = *chunk_;
+            }
+            return *this;
+        }
+
+        Iterator& operator--() {
+            if (current_ == *chunk_) {
+                --chunk_;
+                current_ = *chunk_ + kChunkSize;
+            }
+            --current_;
+            return *this;
+        }
+
+        Value& operator*() const {
+            return *current_;
+        }
+
+        Value* operator->() const {
+            return current_;
+        }
+
+        bool operator==(const Iterator &rhs) const {
+            return current_ == rhs.current_;
+        }
+
+        bool operator!=(const Iterator &rhs) const {
+            return current_ != rhs.current_;
+        }
+    };
+
+public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    Deque() : map_(1, nullptr), spare_(nullptr), front_(0), size_(0) {
+        ensure_chunk(0);
+    }
+
+    Deque(const Deque &deque) : Deque() {
+        for (const T &value : deque) {
+            push_back(value);
+        }
+    }
+
+    Deque& operator=(const Deque &deque) {
+        if (&deque == this) {
+            return *this;
+        }
+        Deque copy(deque);
+        swap(copy);
+        return *this;
+    }
+
+    ~Deque() {
+        clear();
+        for (size_t i = 0; i < map_.size(); ++i) {
+            if (map_[i] != nullptr) {
+                std::allocator<T>().deallocate(map_[i], kChunkSize);
+            }
+        }
+        if (spare_ != nullptr) {
+            std::allocator<T>().deallocate(spare_, kChunkSize);
+        }
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if ((front_ + size_ + 1) / kChunkSize >= map_.size()) {
+            recentre();
+        }
+        size_t position = front_ + size_;
+        ensure_chunk((position + 1) / kChunkSize);
+        T *element = new (slot(position)) T(std::forward<Args>(args)...);
+        ++size_;
+        return *element;
+    }
+
+    template <typename... Args>
+    T& emplace_front(Args&&... args) {
+        if (front_ == 0) {
+            recentre();
+        }
+        ensure_chunk((front_ - 1) / kChunkSize);
+        T *element = new (slot(front_ - 1)) T(std::forward<Args>(args)...);
+        --front_;
+        ++size_;
+        return *element;
+    }
+
+    void push_back(const T &value) {
+        emplace_back(value);
+    }
+
+    void push_back(T &&value) {
+        emplace_back(std::move(value));
+    }
+
+    void push_front(const T &value) {
+        emplace_front(value);
+    }
+
+    void push_front(T &&value) {
+        emplace_front(std::move(value));
+    }
+
+    void pop_back() {
+        std::destroy_at(slot(front_ + size_ - 1));
+        --size_;
+        size_t end = front_ + size_;
+        if (end % kChunkSize == kChunkSize - 1) {
+            release_chunk(end / kChunkSize + 1);
+        }
+        rewind_if_empty();
+    }
+
+    void pop_front() {
+        std::destroy_at(slot(front_));
+        ++front_;
+        --size_;
+        if (front_ % kChunkSize == 0) {
+            release_chunk(front_ / kChunkSize - 1);
+        }
+        rewind_if_empty();
+    }
+
+    // Keeps one chunk, and the spare, for the next pushes.
+    void clear() {
+        for (size_t i = 0; i < size_; ++i) {
+            std::destroy_at(slot(front_ + i));
+        }
+        size_t first = front_ / kChunkSize;
+        size_t last = (front_ + size_) / kChunkSize;
+        for (size_t chunk = first + 1; chunk <= last; ++chunk) {
+            release_chunk(chunk);
+        }
+        size_ = 0;
+        rewind_if_empty();
+    }
+
+    void swap(Deque &deque) {
+        map_.swap(deque.map_);
+        std::swap(spare_, deque.spare_);
+        std::swap(front_, deque.front_);
+        std::swap(size_, deque.size_);
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    T& front() {
+        return *slot(front_);
+    }
+
+    const T& front() const {
+        return *slot(front_);
+    }
+
+    T& back() {
+        return *slot(front_ + size_ - 1);
+    }
+
+    const T& back() const {
+        return *slot(front_ + size_ - 1);
+    }
+
+    T& operator[](size_t index) {
+        return *slot(front_ + index);
+    }
+
+    const T& operator[](size_t index) const {
+        return *slot(front_ + index);
+    }
+
+    iterator begin() {
+        return make_iterator<false>(front_);
+    }
+
+    const_iterator begin() const {
+        return make_iterator<true>(front_);
+    }
+
+    iterator end() {
+        return make_iterator<false>(front_ + size_);
+    }
+
+    const_iterator end() const {
+        return make_iterator<true>(front_ + size_);
+    }
+
+private:
+    template <bool Const>
+    Iterator<Const> make_iterator(size_t position) const {
+        size_t chunk = position / kChunkSize;
+        return Iterator<Const>(map_.begin() + chunk, map_[chunk] + position % kChunkSize);
+    }
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "FlatSet.cpp"
+#include "Vector.cpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+// Sorted map over two parallel Vectors, keys and values, so searches only
+// touch the key array. Lookups are a branchless binary search; insert and
+// erase shift the tail and cost O(n).
+template <typename K, typename V, typename Compare = std::less<K>>
+class FlatMap {
+    Vector<K> keys_;
+    Vector<V> values_;
+    Compare less_;
+
+    size_t lower_index(const K &key) const {
+        return BranchlessLowerBound(keys_.begin(), keys_.size(), key, less_) - keys_.begin();
+    }
+
+    bool found(size_t index, const K &key) const {
+        return index != keys_.size() && !less_(key, keys_[index]);
+    }
+
+public:
+    FlatMap(const Compare &less = Compare()) : less_(less) {
+    }
+
+    // Sorts once; of entries with equal keys the first one is kept.
+    explicit FlatMap(Vector<std::pair<K, V>> entries, const Compare &less = Compare())
+        : less_(less) {
+        auto by_key = [this](const std::pair<K, V> &a, const std::pair<K, V> &b) {
+            return less_(a.first, b.first);
+        };
+        std::stable_sort(entries.begin(), entries.end(), by_key);
+        keys_.reserve(entries.size());
+        values_.reserve(entries.size());
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (i != 0 && !less_(keys_[keys_.size() - 1], entries[i].first)) {
+                continue;
+            }
+            keys_.push_back(std::move(entries[i].first));
+            values_.push_back(std::move(entries[i].second));
+        }
+    }
+
+    V* find(const K &key) {
+        size_t index = lower_index(key);
+        return found(index, key) ? &values_[index] : nullptr;
+    }
+
+    const V* find(const K &key) const {
+        size_t index = lower_index(key);
+        return found(index, key) ? &values_[index] : nullptr;
+    }
+
+    bool contains(const K &key) const {
+        return found(lower_index(key), key);
+    }
+
+    // Returns false, leaving the stored value alone, if the key was present.
+    bool insert(const K &key, const V &value) {
+        size_t index = lower_index(key);
+        if (found(index, key)) {
+            return false;
+        }
+        keys_.emplace(keys_.begin() + index, key);
+        try {
+            values_.emplace(values_.begin() + index, value);
+        } catch (...) {
+            keys_.erase(keys_.begin() + index, keys_.begin() + index + 1);
+            throw;
+        }
+        return true;
+    }
+
+    void insert_or_assign(const K &key, const V &value) {
+        if (V *stored = find(key)) {
+            *stored = value;
+        } else {
+            insert(key, value);
+        }
+    }
+
+    // Value for key, default-constructed first if missing.
+    V& operator[](const K &key) {
+        size_t index = lower_index(key);
+        if (!found(index, key)) {
+            insert(key, V());
+        }
+        return values_[index];
+    }
+
+    size_t erase(const K &key) {
+        size_t index = lower_index(key);
+        if (!found(index, key)) {
+            return 0;
+        }
+        keys_.erase(keys_.begin() + index, keys_.begin() + index + 1);
+        values_.erase(values_.begin() + index, values_.begin() + index + 1);
+        return 1;
+    }
+
+    void reserve(size_t size) {
+        keys_.reserve(size);
+        values_.reserve(size);
+    }
+
+    void clear() {
+        keys_.clear();
+        values_.clear();
+    }
+
+    size_t size() const {
+        return keys_.size();
+    }
+
+    const Vector<K>& keys() const {
+        return keys_;
+    }
+
+    const Vector<V>& values() const {
+        return values_;
+    }
+
+    const K& key(size_t index) const {
+        return keys_[index];
+    }
+
+    V& value(size_t index) {
+        return values_[index];
+    }
+
+    const V& value(size_t index) const {
+        return values_[index];
+    }
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Vector.cpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+// lower_bound over a sorted array whose loop body compiles to a conditional
+// move instead of a branch, so lookups do not pay for mispredictions.
+template <typename K, typename Compare>
+const K* BranchlessLowerBound(const K *first, size_t n, const K &key, Compare less) {
+    if (n == 0) {
+        return first;
+    }
+    while (n > 1) {
+        size_t half = n / 2;
+        first = less(first[half], key) ? first + half : first;
+        n -= half;
+    }
+    return first + less(*first, key);
+}
+
+// Sorted set kept in one Vector: compact and fast to scan and search, with
+// O(n) insert and erase. Best built in bulk from unsorted keys.
+template <typename K, typename Compare = std::less<K>>
+class FlatSet {
+    Vector<K> keys_;
+    Compare less_;
+
+public:
+    FlatSet(const Compare &less = Compare()) : less_(less) {
+    }
+
+    // Sorts once and drops duplicates.
+    explicit FlatSet(Vector<K> keys, const Compare &less = Compare()) : less_(less) {
+        keys_.swap(keys);
+        std::sort(keys_.begin(), keys_.end(), less_);
+        auto equal = [this](const K &a, const K &b) { return !less_(a, b) && !less_(b, a); };
+        keys_.erase(std::unique(keys_.begin(), keys_.end(), equal), keys_.end());
+    }
+
+    const K* lower_bound(const K &key) const {
+        return BranchlessLowerBound(keys_.begin(), keys_.size(), key, less_);
+    }
+
+    const K* find(const K &key) const {
+        const K *position = lower_bound(key);
+        return position != end() && !less_(key, *position) ? position : end();
+    }
+
+    bool contains(const K &key) const {
+        return find(key) != end();
+    }
+
+    // Returns false if the key was already present.
+    bool insert(const K &key) {
+        const K *position = lower_bound(key);
+        if (position != end() && !less_(key, *position)) {
+            return false;
+        }
+        keys_.emplace(position, key);
+        return true;
+    }
+
+    size_t erase(const K &key) {
+        const K *position = find(key);
+        if (position == end()) {
+            return 0;
+        }
+        keys_.erase(position, position + 1);
+        return 1;
+    }
+
+    void reserve(size_t size) {
+        keys_.reserve(size);
+    }
+
+    void clear() {
+        keys_.clear();
+    }
+
+    size_t size() const {
+        return keys_.size();
+    }
+
+    const K* begin() const {
+        return keys_.begin();
+    }
+
+    const K* end() const {
+        return keys_.end();
+    }
+
+    const K& operator[](size_t index) const {
+        return keys_[index];
+    }
+};
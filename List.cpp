@@ -1,114 +1,510 @@
+#pragma once
+
+#include "allocators.h"
+#include <atomic>
 #include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+
+// Doubly linked list. Nodes come from a SlabPool, so pushes and pops recycle
+// nodes through a free list instead of hitting the heap each time.
+//
+// Each list owns a pool of its own, and every node remembers the pool it came
+// from. splice and merge just relink nodes, so a list may end up holding
+// nodes of other lists' pools. Such a node goes back to its own pool when it
+// is freed, through a lock-free stack that the owning list drains on its next
+// allocation, so lists that exchanged nodes may still be used from different
+// threads, such as a batch built locally and spliced into a queue that a
+// consumer drains. A pool outlives its list until the last of its nodes held
+// elsewhere is freed.
+template <typename T, typename Alloc = std::allocator<T>>
 class List {
+    struct NodePool;
+
     struct Node {
-        int value;
+        T value;
         Node *prev, *next;
-        Node(int value, Node *prev, Node *next) : value(value), prev(prev), next(next) {}
+        NodePool *pool;
+
+        template <typename... Args>
+        Node(Node *prev, Node *next, NodePool *pool, Args&&... args)
+            : value(std::forward<Args>(args)...), prev(prev), next(next), pool(pool) {}
     };
-    Node* head_;
-    Node* tail_;
-    size_t size_;
 
-public:
-    List() : head_(nullptr), tail_(nullptr), size_(0) {}
+    using NodeAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
 
-    List& operator= (const List &rhs) {
-        while (size_ > 0) {
-            pop_back();
+    // Allocate and Deallocate are for the owning list only; any list may call
+    // DeallocateRemote. live counts the pool's nodes not yet back in slabs,
+    // which decides when an orphaned pool can go.
+    struct NodePool {
+        // Storage of a freed node while it waits on the remote stack.
+        struct Freed {
+            Freed *next;
+        };
+
+        SlabPool<Node, NodeAlloc> slabs;
+        size_t live = 0;
+        std::atomic<Freed*> remote{nullptr};
+        // Once the owner has gone: its final live count plus one decrement
+        // per remote free since, so it reaches zero with the last node.
+        std::atomic<ptrdiff_t> orphaned_live{0};
+
+        explicit NodePool(const NodeAlloc &allocator) : slabs(allocator) {}
+
+        // Marks the remote stack of a pool whose owner has gone.
+        static Freed* Orphaned() {
+            static Freed marker;
+            return &marker;
         }
-        for (auto i : rhs) {
-            push_back(i);
+
+        Node* Allocate() {
+            if (remote.load(std::memory_order_relaxed) != nullptr) {
+                Freed *freed = remote.exchange(nullptr, std::memory_order_acquire);
+                while (freed != nullptr) {
+                    Freed *next = freed->next;
+                    slabs.Deallocate(reinterpret_cast<Node*>(freed));
+                    --live;
+                    freed = next;
+                }
+            }
+            Node *node = slabs.Allocate();
+            ++live;
+            return node;
         }
-        return *this;
-    }
 
-    ~List() {
-        while (size_ > 0) {
-            pop_back();
+        void Deallocate(Node *node) {
+            slabs.Deallocate(node);
+            --live;
         }
-    }
 
-    void push_back(int item) {
-        if (size_ ==0) {
-            head_ = tail_ = new Node(item, nullptr, nullptr);
-        } else {
-            tail_ = tail_->next = new Node(item, tail_, nullptr);
+        static void DeallocateRemote(NodePool *pool, Node *node) {
+            Freed *freed = new (node) Freed;
+            Freed *head = pool->remote.load(std::memory_order_relaxed);
+            do {
+                if (head == Orphaned()) {
+                    if (pool->orphaned_live.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        delete pool;
+                    }
+                    return;
+                }
+                freed->next = head;
+            } while (!pool->remote.compare_exchange_weak(head, freed, std::memory_order_release,
+                                                         std::memory_order_relaxed));
         }
-        ++size_;
-    }
 
-    void push_front(int item) {
-        if (size_ == 0) {
-            head_ = tail_ = new Node(item, nullptr, nullptr);
-        } else {
-            head_ = head_->prev = new Node(item, nullptr, head_);
+        // Called by the owner as it goes. Nodes already freed remotely are
+        // counted off, and the pool dies now or with its last node elsewhere.
+        static void Release(NodePool *pool) {
+            Freed *freed = pool->remote.exchange(Orphaned(), std::memory_order_acquire);
+            for (; freed != nullptr; freed = freed->next) {
+                --pool->live;
+            }
+            ptrdiff_t live = pool->live;
+            if (pool->orphaned_live.fetch_add(live, std::memory_order_acq_rel) + live == 0) {
+                delete pool;
+            }
         }
-        ++size_;
-    }
+    };
 
-    void pop_front() {
-        Node* ptr = head_;
-        head_ = head_->next;
-        if (size_ == 1) {
-            tail_ = nullptr;
-        } else {
-            head_->prev = nullptr;
+    NodeAlloc allocator_;
+    NodePool* pool_;  // created on the first push
+    Node* head_;
+    Node* tail_;
+    size_t size_;
+
+    template <typename... Args>
+    Node* create_node(Args&&... args) {
+        if (pool_ == nullptr) {
+            pool_ = new NodePool(allocator_);
+        }
+        Node* node = pool_->Allocate();
+        try {
+            return new (node) Node(nullptr, nullptr, pool_, std::forward<Args>(args)...);
+        } catch (...) {
+            pool_->Deallocate(node);
+            throw;
         }
-        delete ptr;
-        --size_;
     }
 
-    void pop_back() {
-        Node* ptr = tail_;
-        tail_ = tail_->prev;
-        if (size_ == 1) {
-            head_ = nullptr;
+    void destroy_node(Node *node) {
+        NodePool* pool = node->pool;
+        std::destroy_at(node);
+        if (pool == pool_) {
+            pool_->Deallocate(node);
         } else {
-            tail_->next = nullptr;
+            NodePool::DeallocateRemote(pool, node);
         }
-        delete ptr;
-        --size_;
     }
 
-    size_t size() const {
-        return size_;
+    // Links node in before position, nullptr meaning the end.
+    void link(Node *position, Node *node) {
+        node->next = position;
+        node->prev = position != nullptr ? position->prev : tail_;
+        (node->prev != nullptr ? node->prev->next : head_) = node;
+        (position != nullptr ? position->prev : tail_) = node;
+    }
+
+    // Unlinks the chain [first, last] without touching its inner links.
+    void unlink(Node *first, Node *last) {
+        (first->prev != nullptr ? first->prev->next : head_) = last->next;
+        (last->next != nullptr ? last->next->prev : tail_) = first->prev;
     }
 
-    class ConstIterator {
+    // Links the chain [first, last] in before position.
+    void link_chain(Node *position, Node *first, Node *last) {
+        first->prev = position != nullptr ? position->prev : tail_;
+        last->next = position;
+        (first->prev != nullptr ? first->prev->next : head_) = first;
+        (position != nullptr ? position->prev : tail_) = last;
+    }
+
+    template <bool Const>
+    class BasicIterator {
+        using Value = std::conditional_t<Const, const T, T>;
+
         const List* list_ptr;
         Node* i_;
 
+        friend class List;
+
     public:
-        ConstIterator(const List* value, Node* i) : list_ptr(value), i_(i) {}
+        BasicIterator(const List* value, Node* i) : list_ptr(value), i_(i) {}
 
-        ConstIterator& operator++ () {
+        operator BasicIterator<true>() const {
+            return BasicIterator<true>(list_ptr, i_);
+        }
+
+        BasicIterator& operator++ () {
             i_ = i_->next;
             return *this;
         }
 
-        ConstIterator& operator-- () {
+        BasicIterator& operator-- () {
             i_ = (i_ != nullptr ? i_->prev : list_ptr->tail_);
             return *this;
         }
 
-        int operator*() const {
+        Value& operator*() const {
             return i_-> value;
         }
 
-        bool operator == (const ConstIterator &rhs) const {
+        Value* operator->() const {
+            return &i_->value;
+        }
+
+        bool operator == (const BasicIterator &rhs) const {
             return ((i_ ==rhs.i_) && (list_ptr == rhs.list_ptr));
         }
 
-        bool operator != (const ConstIterator &rhs) const {
+        bool operator != (const BasicIterator &rhs) const {
             return ((i_ != rhs.i_) || (list_ptr != rhs.list_ptr));
         }
     };
 
+public:
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+    using iterator = Iterator;
+    using const_iterator = ConstIterator;
+
+    List(const Alloc &allocator = Alloc())
+        : allocator_(allocator), pool_(nullptr), head_(nullptr), tail_(nullptr), size_(0) {}
+
+    List(const List &rhs)
+        : List(std::allocator_traits<NodeAlloc>::select_on_container_copy_construction(
+              rhs.allocator_)) {
+        for (const T &i : rhs) {
+            push_back(i);
+        }
+    }
+
+    // Assigns over the existing nodes and only creates or frees the surplus.
+    List& operator= (const List &rhs) {
+        if (&rhs == this) {
+            return *this;
+        }
+        Node* to = head_;
+        Node* from = rhs.head_;
+        for (; to != nullptr && from != nullptr; to = to->next, from = from->next) {
+            to->value = from->value;
+        }
+        for (; from != nullptr; from = from->next) {
+            push_back(from->value);
+        }
+        while (size_ > rhs.size_) {
+            pop_back();
+        }
+        return *this;
+    }
+
+    ~List() {
+        clear();
+        if (pool_ != nullptr) {
+            NodePool::Release(pool_);
+        }
+    }
+
+    template <typename... Args>
+    Iterator emplace(ConstIterator position, Args&&... args) {
+        Node* node = create_node(std::forward<Args>(args)...);
+        link(position.i_, node);
+        ++size_;
+        return Iterator(this, node);
+    }
+
+    Iterator insert(ConstIterator position, const T &item) {
+        return emplace(position, item);
+    }
+
+    Iterator insert(ConstIterator position, T &&item) {
+        return emplace(position, std::move(item));
+    }
+
+    Iterator erase(ConstIterator position) {
+        Node* node = position.i_;
+        Node* next = node->next;
+        unlink(node, node);
+        destroy_node(node);
+        --size_;
+        return Iterator(this, next);
+    }
+
+    Iterator erase(ConstIterator first, ConstIterator last) {
+        while (first != last) {
+            first = erase(first);
+        }
+        return Iterator(this, last.i_);
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        return *emplace(end(), std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    T& emplace_front(Args&&... args) {
+        return *emplace(begin(), std::forward<Args>(args)...);
+    }
+
+    void push_back(const T &item) {
+        emplace_back(item);
+    }
+
+    void push_back(T &&item) {
+        emplace_back(std::move(item));
+    }
+
+    void push_front(const T &item) {
+        emplace_front(item);
+    }
+
+    void push_front(T &&item) {
+        emplace_front(std::move(item));
+    }
+
+    void pop_front() {
+        erase(begin());
+    }
+
+    void pop_back() {
+        erase(ConstIterator(this, tail_));
+    }
+
+    // Emptied nodes stay in the pool for later pushes.
+    void clear() {
+        while (size_ > 0) {
+            pop_back();
+        }
+    }
+
+    // Moves all of other's elements before position in O(1). Iterators keep
+    // the list they came from, so take new ones for moved elements.
+    void splice(ConstIterator position, List &other) {
+        if (&other == this || other.size_ == 0) {
+            return;
+        }
+        link_chain(position.i_, other.head_, other.tail_);
+        size_ += other.size_;
+        other.head_ = other.tail_ = nullptr;
+        other.size_ = 0;
+    }
+
+    // Moves the element at it from other before position in O(1).
+    void splice(ConstIterator position, List &other, ConstIterator it) {
+        Node* node = it.i_;
+        if (&other == this && (node == position.i_ || node->next == position.i_)) {
+            return;
+        }
+        other.unlink(node, node);
+        link(position.i_, node);
+        --other.size_;
+        ++size_;
+    }
+
+    // Moves [first, last) from other before position. O(1) within one list,
+    // linear in the range length between two lists, which must count it.
+    void splice(ConstIterator position, List &other, ConstIterator first, ConstIterator last) {
+        if (first == last) {
+            return;
+        }
+        size_t count = 0;
+        Node* back = nullptr;
+        if (&other != this) {
+            for (Node* node = first.i_; node != last.i_; node = node->next) {
+                back = node;
+                ++count;
+            }
+            } else {
+            back = last.i_ != nullptr ? last.i_->prev : tail_;
+        }
+        other.unlink(first.i_, back);
+        link_chain(position.i_, first.i_, back);
+        other.size_ -= count;
+        size_ += count;
+    }
+
+    // Merges sorted other into this sorted list by relinking its nodes. Stable:
+    // equal elements of this list come first.
+    template <typename Compare = std::less<>>
+    void merge(List &other, Compare less = Compare()) {
+        if (&other == this || other.size_ == 0) {
+            return;
+        }
+        Node* position = head_;
+        Node* node = other.head_;
+        while (node != nullptr) {
+            if (position == nullptr) {
+                link_chain(nullptr, node, other.tail_);
+                break;
+            }
+            if (less(node->value, position->value)) {
+                Node* next = node->next;
+                link(position, node);
+                node = next;
+            } else {
+                position = position->next;
+            }
+        }
+        size_ += other.size_;
+        other.head_ = other.tail_ = nullptr;
+        other.size_ = 0;
+    }
+
+    // Stable bottom-up merge sort. Nodes are relinked in place, so elements
+    // never move and iterators stay valid.
+    template <typename Compare = std::less<>>
+    void sort(Compare less = Compare()) {
+        if (size_ < 2) {
+            return;
+        }
+        Node* list = head_;
+        for (size_t width = 1;; width *= 2) {
+            Node* p = list;
+            Node* last = nullptr;
+            size_t merges = 0;
+            list = nullptr;
+            // Merges neighbouring runs of width elements, rebuilding prev
+            // links on the way.
+            while (p != nullptr) {
+                ++merges;
+                Node* q = p;
+                size_t p_size = 0;
+                while (p_size < width && q != nullptr) {
+                    ++p_size;
+                    q = q->next;
+                }
+                size_t q_size = width;
+                while (p_size > 0 || (q_size > 0 && q != nullptr)) {
+                    Node* node;
+                    if (p_size == 0 || (q_size > 0 && q != nullptr && less(q->value, p->value))) {
+                        node = q;
+                        q = q->next;
+                        --q_size;
+                    } else {
+                        node = p;
+                        p = p->next;
+                        --p_size;
+                    }
+                    (last != nullptr ? last->next : list) = node;
+                    node->prev = last;
+                    last = node;
+                }
+                p = q;
+            }
+            last->next = nullptr;
+            if (merges == 1) {
+                head_ = list;
+                tail_ = last;
+                return;
+            }
+        }
+    }
+
+    // Erases every element equal to the one before it; returns the count.
+    template <typename Equal = std::equal_to<>>
+    size_t unique(Equal equal = Equal()) {
+        size_t removed = 0;
+        if (size_ == 0) {
+            return removed;
+        }
+        for (Node* node = head_; node->next != nullptr;) {
+            if (equal(node->value, node->next->value)) {
+                erase(ConstIterator(this, node->next));
+                ++removed;
+            } else {
+                node = node->next;
+            }
+        }
+        return removed;
+    }
+
+    void swap(List &rhs) {
+        std::swap(allocator_, rhs.allocator_);
+        std::swap(pool_, rhs.pool_);
+        std::swap(head_, rhs.head_);
+        std::swap(tail_, rhs.tail_);
+        std::swap(size_, rhs.size_);
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    T& front() {
+        return head_->value;
+    }
+
+    const T& front() const {
+        return head_->value;
+    }
+
+    T& back() {
+        return tail_->value;
+    }
+
+    const T& back() const {
+        return tail_->value;
+    }
+
+    Iterator begin() {
+        return Iterator(this, head_);
+    }
+
     ConstIterator begin() const {
         return ConstIterator(this, head_);
     }
 
+    // The past-the-end node is nullptr, which also holds for an empty list.
+    Iterator end() {
+        return Iterator(this, nullptr);
+    }
+
     ConstIterator end() const {
-        return ConstIterator(this, tail_->next);
+        return ConstIterator(this, nullptr);
     }
 };
@@ -0,0 +1,250 @@
+#pragma once
+
+#include "Vector.cpp"
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct MappedVectorHeader {
+    static constexpr uint64_t kMagic = 0x524f544345564d4dULL;  // "MMVECTOR"
+
+    uint64_t magic;
+    uint64_t type_tag;
+    uint64_t element_size;
+    uint64_t element_align;
+    uint64_t size;
+    uint64_t capacity;
+};
+
+// Vector whose elements live in a memory-mapped file laid out as a header
+// followed by the raw elements. Reopening the file gives back the same
+// contents without any parsing. type_tag is an arbitrary user value checked
+// on open, together with sizeof(T) and alignof(T).
+template <typename T, typename Growth = DoublingGrowth>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "elements are stored as raw bytes");
+
+    static constexpr size_t kDataOffset =
+        (sizeof(MappedVectorHeader) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+    int fd;
+    char *bytes;
+    size_t mapped;
+
+    MappedVectorHeader& header();
+    const MappedVectorHeader& header() const;
+    void map(size_t capacity);
+
+public:
+    MappedVector(const char *path, uint64_t type_tag = 0);
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+    void reserve(size_t size);
+    void resize(size_t size);
+    void clear();
+    void push_back(const T &value);
+    void pop_back();
+    void sync();
+    size_t size() const;
+    size_t capacity() const;
+    T* begin();
+    const T* begin() const;
+    T* end();
+    const T* end() const;
+    T& operator[](size_t index);
+    const T& operator[](size_t index) const;
+    ~MappedVector();
+};
+
+template <typename T, typename Growth>
+MappedVectorHeader& MappedVector<T, Growth>::header() {
+    return *reinterpret_cast<MappedVectorHeader*>(bytes);
+}
+
+template <typename T, typename Growth>
+const MappedVectorHeader& MappedVector<T, Growth>::header() const {
+    return *reinterpret_cast<const MappedVectorHeader*>(bytes);
+}
+
+// Resizes the file to hold capacity elements and maps all of it.
+template <typename T, typename Growth>
+void MappedVector<T, Growth>::map(size_t capacity) {
+    size_t length = kDataOffset + capacity * sizeof(T);
+    if (ftruncate(fd, length) != 0) {
+        throw std::system_error(errno, std::generic_category(), "MappedVector: ftruncate");
+    }
+    void *ptr;
+    if (bytes == nullptr) {
+        ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    } else {
+#ifdef __linux__
+        ptr = mremap(bytes, mapped, length, MREMAP_MAYMOVE);
+#else
+        // Both map the same file, so the old mapping is dropped only once the
+        // new one exists; on failure this one stays intact.
+        ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (ptr != MAP_FAILED) {
+            munmap(bytes, mapped);
+        }
+#endif
+    }
+    if (ptr == MAP_FAILED) {
+        throw std::system_error(errno, std::generic_category(), "MappedVector: mmap");
+    }
+    bytes = static_cast<char*>(ptr);
+    mapped = length;
+}
+
+template <typename T, typename Growth>
+MappedVector<T, Growth>::MappedVector(const char *path, uint64_t type_tag) {
+    bytes = nullptr;
+    mapped = 0;
+    fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "MappedVector: open");
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), "MappedVector: fstat");
+    }
+
+    try {
+        if (info.st_size == 0) {
+            map(0);
+            header() = {MappedVectorHeader::kMagic, type_tag, sizeof(T), alignof(T), 0, 0};
+            return;
+        }
+        if (static_cast<size_t>(info.st_size) < kDataOffset) {
+            throw std::runtime_error("MappedVector: file is too short");
+        }
+        bytes = static_cast<char*>(
+            mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+        if (bytes == MAP_FAILED) {
+            bytes = nullptr;
+            throw std::system_error(errno, std::generic_category(), "MappedVector: mmap");
+        }
+        mapped = info.st_size;
+        const MappedVectorHeader &stored = header();
+        if (stored.magic != MappedVectorHeader::kMagic || stored.type_tag != type_tag ||
+            stored.element_size != sizeof(T) || stored.element_align != alignof(T) ||
+            stored.size > stored.capacity ||
+            kDataOffset + stored.capacity * sizeof(T) > mapped) {
+            throw std::runtime_error("MappedVector: header does not match element type");
+        }
+    } catch (...) {
+        if (bytes != nullptr) {
+            munmap(bytes, mapped);
+        }
+        close(fd);
+        throw;
+    }
+}
+
+template <typename T, typename Growth>
+void MappedVector<T, Growth>::reserve(size_t size) {
+    if (size <= header().capacity)
+        return;
+
+    map(size);
+    header().capacity = size;
+}
+
+template <typename T, typename Growth>
+void MappedVector<T, Growth>::resize(size_t size) {
+    reserve(size);
+
+    size_t count = header().size;
+    if (size > count) {
+        std::uninitialized_value_construct_n(begin() + count, size - count);
+    }
+    header().size = size;
+}
+
+template <typename T, typename Growth>
+void MappedVector<T, Growth>::clear() {
+    header().size = 0;
+}
+
+template <typename T, typename Growth>
+void MappedVector<T, Growth>::push_back(const T &value) {
+    if (header().size == header().capacity) {
+        // Remapping may move or unmap the pages value lives in.
+        T copy = value;
+        reserve(Growth::next(header().capacity));
+        new (begin() + header().size) T(copy);
+    } else {
+        new (begin() + header().size) T(value);
+    }
+    header().size++;
+}
+
+template <typename T, typename Growth>
+void MappedVector<T, Growth>::pop_back() {
+    header().size--;
+}
+
+// Flushes the mapping to the file; the kernel does it eventually anyway.
+template <typename T, typename Growth>
+void MappedVector<T, Growth>::sync() {
+    if (msync(bytes, mapped, MS_SYNC) != 0) {
+        throw std::system_error(errno, std::generic_category(), "MappedVector: msync");
+    }
+}
+
+template <typename T, typename Growth>
+size_t MappedVector<T, Growth>::size() const {
+    return header().size;
+}
+
+template <typename T, typename Growth>
+size_t MappedVector<T, Growth>::capacity() const {
+    return header().capacity;
+}
+
+template <typename T, typename Growth>
+T* MappedVector<T, Growth>::begin() {
+    return reinterpret_cast<T*>(bytes + kDataOffset);
+}
+
+template <typename T, typename Growth>
+const T* MappedVector<T, Growth>::begin() const {
+    return reinterpret_cast<const T*>(bytes + kDataOffset);
+}
+
+template <typename T, typename Growth>
+T* MappedVector<T, Growth>::end() {
+    return begin() + header().size;
+}
+
+template <typename T, typename Growth>
+const T* MappedVector<T, Growth>::end() const {
+    return begin() + header().size;
+}
+
+template <typename T, typename Growth>
+T& MappedVector<T, Growth>::operator[](size_t index) {
+    return begin()[index];
+}
+
+template <typename T, typename Growth>
+const T& MappedVector<T, Growth>::operator[](size_t index) const {
+    return begin()[index];
+}
+
+template <typename T, typename Growth>
+MappedVector<T, Growth>::~MappedVector() {
+    munmap(bytes, mapped);
+    close(fd);
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "relocation.h"
 #include <cstddef>  // std::nullptr_t
 #include <utility>
 #include <algorithm>
@@ -246,3 +247,8 @@ public:
     SharedPtr<T> SharedFromThis();
     SharedPtr<const T> SharedFromThis() const;
 };
+
+// The control block is referenced, never owned by address, so a memcpy keeps
+// the reference count intact.
+template <typename T>
+struct IsTriviallyRelocatable<SharedPtr<T>> : std::true_type {};
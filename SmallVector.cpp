@@ -0,0 +1,265 @@
+#pragma once
+
+#include "Vector.cpp"
+#include "relocation.h"
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Vector that keeps up to N elements inline and only allocates a
+// VectorMemory block once it outgrows them. VectorStats counts elements as
+// used only while they live in that block, the inline ones are not counted
+// as storage either.
+template <typename T, size_t N, typename Alloc = std::allocator<T>>
+class SmallVector {
+    static_assert(N > 0, "use Vector for vectors without inline storage");
+
+    using VectorMemory = ::VectorMemory<T, Alloc>;
+
+    alignas(T) unsigned char storage[N * sizeof(T)];
+    VectorMemory heap;
+    T *data;
+    size_t count;
+
+    bool is_inline() const;
+    void steal(SmallVector &&vector);
+    void on_resize(size_t old_size, size_t new_size) const;
+
+public:
+    using allocator_type = Alloc;
+
+    SmallVector(const Alloc &allocator = Alloc());
+    SmallVector(size_t size, const Alloc &allocator = Alloc());
+    SmallVector(const SmallVector& vector);
+    SmallVector(SmallVector&& vector);
+    SmallVector& operator=(const SmallVector& vector);
+    SmallVector& operator=(SmallVector&& vector);
+    void reserve(size_t size);
+    void resize(size_t size);
+    void clear();
+    void push_back(const T &value);
+    void push_back(T &&value);
+    void pop_back();
+    void swap(SmallVector &vector);
+    size_t size() const;
+    size_t capacity() const;
+    T* begin();
+    const T* begin() const;
+    T* end();
+    const T* end() const;
+    T& operator[](size_t index);
+    const T& operator[](size_t index) const;
+    Alloc get_allocator() const;
+    ~SmallVector();
+};
+
+template <typename T, size_t N, typename Alloc>
+bool SmallVector<T, N, Alloc>::is_inline() const {
+    return heap.bytes == nullptr;
+}
+
+template <typename T, size_t N, typename Alloc>
+void SmallVector<T, N, Alloc>::on_resize(size_t old_size, size_t new_size) const {
+    if (!is_inline()) {
+        VectorStats::OnResize<T>(old_size, new_size);
+    }
+}
+
+// Takes over the elements of vector; *this must be empty and inline.
+template <typename T, size_t N, typename Alloc>
+void SmallVector<T, N, Alloc>::steal(SmallVector &&vector) {
+    if (vector.is_inline()) {
+        UninitializedRelocateN(vector.data, vector.count, data);
+    } else {
+        heap.swap(vector.heap);
+        data = heap.begin();
+        vector.data = reinterpret_cast<T*>(vector.storage);
+    }
+    count = vector.count;
+    vector.count = 0;
+}
+
+template <typename T, size_t N, typename Alloc>
+SmallVector<T, N, Alloc>::SmallVector(const Alloc &allocator) : heap(allocator) {
+    data = reinterpret_cast<T*>(storage);
+    count = 0;
+}
+
+template <typename T, size_t N, typename Alloc>
+SmallVector<T, N, Alloc>::SmallVector(size_t size, const Alloc &allocator)
+    : SmallVector(allocator) {
+    resize(size);
+}
+
+template <typename T, size_t N, typename Alloc>
+SmallVector<T, N, Alloc>::SmallVector(const SmallVector& vector)
+    : SmallVector(std::allocator_traits<Alloc>::select_on_container_copy_construction(
+          vector.heap.allocator)) {
+    reserve(vector.count);
+    std::uninitialized_copy_n(vector.data, vector.count, data);
+    on_resize(0, vector.count);
+    count = vector.count;
+}
+
+template <typename T, size_t N, typename Alloc>
+SmallVector<T, N, Alloc>::SmallVector(SmallVector&& vector) : SmallVector(vector.heap.allocator) {
+    steal(std::move(vector));
+}
+
+template <typename T, size_t N, typename Alloc>
+SmallVector<T, N, Alloc>& SmallVector<T, N, Alloc>::operator=(const SmallVector& vector) {
+    if (&vector == this) {
+        return *this;
+    }
+    SmallVector copy(vector);
+    swap(copy);
+    return *this;
+}
+
+template <typename T, size_t N, typename Alloc>
+SmallVector<T, N, Alloc>& SmallVector<T, N, Alloc>::operator=(SmallVector&& vector) {
+    if (&vector == this) {
+        return *this;
+    }
+    clear();
+    VectorMemory released(heap.allocator);
+    released.swap(heap);
+    data = reinterpret_cast<T*>(storage);
+    steal(std::move(vector));
+    return *this;
+}
+
+template <typename T, size_t N, typename Alloc>
+void SmallVector<T, N, Alloc>::reserve(size_t size) {
+    if (size <= capacity())
+        return;
+
+    bool was_inline = is_inline();
+    VectorMemory tmp(size, heap.allocator);
+    UninitializedRelocateN(data, count, tmp.begin());
+    tmp.swap(heap);
+    data = heap.begin();
+    if (was_inline) {
+        VectorStats::OnResize<T>(0, count);
+    }
+}
+
+template <typename T, size_t N, typename Alloc>
+void SmallVector<T, N, Alloc>::resize(size_t size) {
+    reserve(size);
+
+    if (size > count) {
+        std::uninitialized_value_construct_n(data + count, size - count);
+    } else if (size < count) {
+        std::destroy_n(data + size, count - size);
+    }
+
+    on_resize(count, size);
+    count = size;
+}
+
+template <typename T, size_t N, typename Alloc>
+void SmallVector<T, N, Alloc>::clear() {
+    std::destroy_n(data, count);
+    on_resize(count, 0);
+    count = 0;
+}
+
+// When the vector is full the new element is built before growing, since
+// value may be one of the elements that growing moves.
+template <typename T, size_t N, typename Alloc>
+void SmallVector<T, N, Alloc>::push_back(const T &value) {
+    if (count == capacity()) {
+        T copy(value);
+        reserve(count * 2);
+        new (data + count) T(std::move(copy));
+    } else {
+        new (data + count) T(value);
+    }
+    on_resize(count, count + 1);
+    count++;
+}
+
+template <typename T, size_t N, typename Alloc>
+void SmallVector<T, N, Alloc>::push_back(T &&value) {
+    if (count == capacity()) {
+        T moved(std::move(value));
+        reserve(count * 2);
+        new (data + count) T(std::move(moved));
+    } else {
+        new (data + count) T(std::move(value));
+    }
+    on_resize(count, count + 1);
+    count++;
+}
+
+template <typename T, size_t N, typename Alloc>
+void SmallVector<T, N, Alloc>::pop_back() {
+    std::destroy_at(data + count - 1);
+    on_resize(count, count - 1);
+    count--;
+}
+
+template <typename T, size_t N, typename Alloc>
+void SmallVector<T, N, Alloc>::swap(SmallVector &vector) {
+    if (!is_inline() && !vector.is_inline()) {
+        heap.swap(vector.heap);
+        std::swap(data, vector.data);
+        std::swap(count, vector.count);
+        return;
+    }
+    SmallVector tmp(std::move(vector));
+    vector = std::move(*this);
+    *this = std::move(tmp);
+}
+
+template <typename T, size_t N, typename Alloc>
+size_t SmallVector<T, N, Alloc>::size() const {
+    return count;
+}
+
+template <typename T, size_t N, typename Alloc>
+size_t SmallVector<T, N, Alloc>::capacity() const {
+    return is_inline() ? N : heap.capacity;
+}
+
+template <typename T, size_t N, typename Alloc>
+T* SmallVector<T, N, Alloc>::begin() {
+    return data;
+}
+
+template <typename T, size_t N, typename Alloc>
+const T* SmallVector<T, N, Alloc>::begin() const {
+    return data;
+}
+
+template <typename T, size_t N, typename Alloc>
+T* SmallVector<T, N, Alloc>::end() {
+    return data + count;
+}
+
+template <typename T, size_t N, typename Alloc>
+const T* SmallVector<T, N, Alloc>::end() const {
+    return data + count;
+}
+
+template <typename T, size_t N, typename Alloc>
+T& SmallVector<T, N, Alloc>::operator[](size_t index) {
+    return data[index];
+}
+
+template <typename T, size_t N, typename Alloc>
+const T& SmallVector<T, N, Alloc>::operator[](size_t index) const {
+    return data[index];
+}
+
+template <typename T, size_t N, typename Alloc>
+Alloc SmallVector<T, N, Alloc>::get_allocator() const {
+    return heap.allocator;
+}
+
+template <typename T, size_t N, typename Alloc>
+SmallVector<T, N, Alloc>::~SmallVector() {
+    std::destroy_n(data, count);
+    on_resize(count, 0);
+}
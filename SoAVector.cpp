@@ -0,0 +1,227 @@
+#pragma once
+
+#include "Vector.cpp"
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+// Contiguous view of one SoAVector column.
+template <typename T>
+class ColumnSpan {
+    T* data_;
+    size_t size_;
+
+public:
+    ColumnSpan(T* data, size_t size) : data_(data), size_(size) {
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    T* data() const {
+        return data_;
+    }
+
+    T* begin() const {
+        return data_;
+    }
+
+    T* end() const {
+        return data_ + size_;
+    }
+
+    T& operator[](size_t index) const {
+        return data_[index];
+    }
+};
+
+// Structure of arrays: element i is the i-th entry of every column, and each
+// field type gets its own VectorMemory column sharing one size and capacity.
+// Scans that only need one field read only that column. operator[] returns a
+// tuple of references standing in for the element, so
+//
+//     auto [x, y] = particles[i];
+//
+// binds x and y to the stored fields.
+template <typename... Fields>
+class SoAVector {
+    static_assert(sizeof...(Fields) > 0);
+
+    template <size_t I>
+    using Field = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    std::tuple<VectorMemory<Fields>...> columns_;
+    size_t capacity_;
+    size_t size_;
+
+    template <size_t I = 0>
+    void grow(size_t capacity) {
+        if constexpr (I < sizeof...(Fields)) {
+            std::get<I>(columns_).grow(capacity, size_);
+            grow<I + 1>(capacity);
+        }
+    }
+
+    // Constructs element index column by column, unwinding the columns already
+    // built if a later field throws.
+    template <size_t I = 0, typename Values>
+    void construct_fields(size_t index, Values &&values) {
+        if constexpr (I < sizeof...(Fields)) {
+            Field<I> *slot = std::get<I>(columns_).begin() + index;
+            new (slot) Field<I>(std::get<I>(std::forward<Values>(values)));
+            try {
+                construct_fields<I + 1>(index, std::forward<Values>(values));
+            } catch (...) {
+                std::destroy_at(slot);
+                throw;
+            }
+        }
+    }
+
+    template <size_t I = 0>
+    void construct_range(size_t start, size_t count) {
+        if constexpr (I < sizeof...(Fields)) {
+            std::get<I>(columns_).construct(start, count);
+            try {
+                construct_range<I + 1>(start, count);
+            } catch (...) {
+                std::get<I>(columns_).destroy(start, count);
+                throw;
+            }
+        }
+    }
+
+    // Keeps VectorStats' used bytes in step with size_ for every column.
+    void on_resize(size_t old_size, size_t new_size) const {
+        (VectorStats::OnResize<Fields>(old_size, new_size), ...);
+    }
+
+    void destroy_range(size_t start, size_t count) {
+        std::apply([start, count](auto &...column) { (column.destroy(start, count), ...); },
+                   columns_);
+    }
+
+    template <size_t... I>
+    std::tuple<Fields&...> reference(size_t index, std::index_sequence<I...>) {
+        return std::tuple<Fields&...>(std::get<I>(columns_)[index]...);
+    }
+
+    template <size_t... I>
+    std::tuple<const Fields&...> reference(size_t index, std::index_sequence<I...>) const {
+        return std::tuple<const Fields&...>(std::get<I>(columns_)[index]...);
+    }
+
+public:
+    using reference_type = std::tuple<Fields&...>;
+    using const_reference_type = std::tuple<const Fields&...>;
+
+    SoAVector() : capacity_(0), size_(0) {
+    }
+
+    SoAVector(const SoAVector &vector) : SoAVector() {
+        reserve(vector.size_);
+        for (size_t i = 0; i < vector.size_; ++i) {
+            construct_fields(i, vector[i]);
+            on_resize(size_, size_ + 1);
+            ++size_;
+        }
+    }
+
+    SoAVector& operator=(const SoAVector &vector) {
+        if (&vector == this) {
+            return *this;
+        }
+        SoAVector copy(vector);
+        swap(copy);
+        return *this;
+    }
+
+    ~SoAVector() {
+        destroy_range(0, size_);
+        on_resize(size_, 0);
+    }
+
+    void reserve(size_t size) {
+        if (size <= capacity_) {
+            return;
+        }
+        grow(size);
+        capacity_ = size;
+    }
+
+    void resize(size_t size) {
+        reserve(size);
+        if (size > size_) {
+            construct_range(size_, size - size_);
+        } else if (size < size_) {
+            destroy_range(size, size_ - size);
+        }
+        on_resize(size_, size);
+        size_ = size;
+    }
+
+    void clear() {
+        destroy_range(0, size_);
+        on_resize(size_, 0);
+        size_ = 0;
+    }
+
+    // When full, the fields are copied out before growing, since values may
+    // refer to fields of an element that growing moves.
+    void push_back(const Fields &...values) {
+        if (size_ == capacity_) {
+            std::tuple<Fields...> copy(values...);
+            reserve(DoublingGrowth::next(capacity_));
+            construct_fields(size_, std::move(copy));
+        } else {
+            construct_fields(size_, std::forward_as_tuple(values...));
+        }
+        on_resize(size_, size_ + 1);
+        ++size_;
+    }
+
+    void pop_back() {
+        destroy_range(size_ - 1, 1);
+        on_resize(size_, size_ - 1);
+        --size_;
+    }
+
+    void swap(SoAVector &vector) {
+        std::apply(
+            [&vector](auto &...column) {
+                std::apply([&column...](auto &...other) { (column.swap(other), ...); },
+                           vector.columns_);
+            },
+            columns_);
+        std::swap(capacity_, vector.capacity_);
+        std::swap(size_, vector.size_);
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    reference_type operator[](size_t index) {
+        return reference(index, std::index_sequence_for<Fields...>());
+    }
+
+    const_reference_type operator[](size_t index) const {
+        return reference(index, std::index_sequence_for<Fields...>());
+    }
+
+    template <size_t I>
+    ColumnSpan<Field<I>> column() {
+        return ColumnSpan<Field<I>>(std::get<I>(columns_).begin(), size_);
+    }
+
+    template <size_t I>
+    ColumnSpan<const Field<I>> column() const {
+        return ColumnSpan<const Field<I>>(std::get<I>(columns_).begin(), size_);
+    }
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "compressed_pair.h"
+#include "relocation.h"
 #include <utility>
 #include <functional>
 #include <cstddef>  // std::nullptr_t
@@ -267,3 +268,7 @@ private:
     template <typename U, typename Q>
     friend class UniquePtr;
 };
+
+// Only a pointer and the deleter live inside, so moving the bytes is enough.
+template <typename T, typename Deleter>
+struct IsTriviallyRelocatable<UniquePtr<T, Deleter>> : IsTriviallyRelocatable<Deleter> {};
@@ -0,0 +1,411 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Doubly linked list of cache-line aligned nodes, each holding up to
+// kNodeCapacity elements in slots [begin, end). Sequential traversal touches
+// one node per kNodeCapacity elements instead of one per element.
+//
+// Pushes at either end fill the end node before adding a new one. A full
+// node is split in half to make room for an insert, and a node left less than
+// half full by an erase absorbs its successor when the two fit together.
+// Inserts and erases invalidate iterators into the nodes they touch.
+template <typename T>
+class UnrolledList {
+    static_assert(std::is_nothrow_move_constructible_v<T>,
+                  "elements are shifted between slots with move construction");
+
+    static constexpr size_t kCacheLine = 64;
+    static constexpr size_t kHeaderSize = 2 * sizeof(void*) + 2 * sizeof(uint32_t);
+
+    // Smallest whole number of cache lines that fits at least eight elements.
+    static constexpr size_t NodeCapacity() {
+        size_t lines = 1;
+        while ((lines * kCacheLine - kHeaderSize) / sizeof(T) < 8) {
+            ++lines;
+        }
+        return (lines * kCacheLine - kHeaderSize) / sizeof(T);
+    }
+
+public:
+    static constexpr size_t kNodeCapacity = NodeCapacity();
+
+private:
+    static constexpr size_t kNodeAlignment = alignof(T) > kCacheLine ? alignof(T) : kCacheLine;
+
+    struct Node {
+        Node *prev, *next;
+        uint32_t begin, end;
+        alignas(T) unsigned char storage[kNodeCapacity * sizeof(T)];
+
+        T* slot(size_t index) {
+            return reinterpret_cast<T*>(storage) + index;
+        }
+
+        size_t count() const {
+            return end - begin;
+        }
+    };
+
+    Node* head_;
+    Node* tail_;
+    size_t size_;
+
+    static Node* new_node(uint32_t position) {
+        Node* node = static_cast<Node*>(::operator new(sizeof(Node), std::align_val_t(kNodeAlignment)));
+        node->prev = node->next = nullptr;
+        node->begin = node->end = position;
+        return node;
+    }
+
+    static void delete_node(Node *node) {
+        ::operator delete(node, std::align_val_t(kNodeAlignment));
+    }
+
+    // Moves count elements between slots, overlapping ranges included.
+    static void move_slots(Node *from, size_t first, size_t count, Node *to, size_t target) {
+        if (from == to && target == first) {
+            return;
+        }
+        if (from != to || target < first) {
+            for (size_t i = 0; i < count; ++i) {
+                new (to->slot(target + i)) T(std::move(*from->slot(first + i)));
+                std::destroy_at(from->slot(first + i));
+            }
+        } else {
+            for (size_t i = count; i-- > 0;) {
+                new (to->slot(target + i)) T(std::move(*from->slot(first + i)));
+                std::destroy_at(from->slot(first + i));
+            }
+        }
+    }
+
+    // Shifts the elements of node so they start at slot begin.
+    static void shift_to(Node *node, uint32_t begin) {
+        size_t count = node->count();
+        move_slots(node, node->begin, count, node, begin);
+        node->begin = begin;
+        node->end = begin + count;
+    }
+
+    void link_after(Node *node, Node *after) {
+        node->prev = after;
+        node->next = after != nullptr ? after->next : head_;
+        (node->next != nullptr ? node->next->prev : tail_) = node;
+        (after != nullptr ? after->next : head_) = node;
+    }
+
+    void unlink(Node *node) {
+        (node->prev != nullptr ? node->prev->next : head_) = node->next;
+        (node->next != nullptr ? node->next->prev : tail_) = node->prev;
+        delete_node(node);
+    }
+
+    // Moves the upper half of a full node into a new node after it.
+    void split(Node *node) {
+        Node* upper = new_node(0);
+        size_t half = node->count() / 2;
+        move_slots(node, node->end - half, half, upper, 0);
+        node->end -= half;
+        upper->end = half;
+        link_after(upper, node);
+    }
+
+    template <bool Const>
+    class Iterator {
+        using Value = std::conditional_t<Const, const T, T>;
+
+        const UnrolledList* list_;
+        Node* node_;
+        size_t slot_;
+
+        friend class UnrolledList;
+
+    public:
+        Iterator(const UnrolledList* list, Node* node, size_t slot)
+            : list_(list), node_(node), slot_(slot) {
+        }
+
+        operator Iterator<true>() const {
+            return Iterator<true>(list_, node_, slot_);
+        }
+
+        Iterator& operator++() {
+            if (++slot_ == node_->end) {
+                node_ = node_->next;
+                slot_ = node_ != nullptr ? node_->begin : 0;
+            }
+            return *this;
+        }
+
+        Iterator& operator--() {
+            if (node_ == nullptr) {
+                node_ = list_->tail_;
+                slot_ = node_->end;
+            } else if (slot_ == node_->begin) {
+                node_ = node_->prev;
+                slot_ = node_->end;
+            }
+            --slot_;
+            return *this;
+        }
+
+        Value& operator*() const {
+            return *node_->slot(slot_);
+        }
+
+        Value* operator->() const {
+            return node_->slot(slot_);
+        }
+
+        bool operator==(const Iterator &rhs) const {
+            return node_ == rhs.node_ && slot_ == rhs.slot_;
+        }
+
+        bool operator!=(const Iterator &rhs) const {
+            return !(*this == rhs);
+        }
+    };
+
+public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    UnrolledList() : head_(nullptr), tail_(nullptr), size_(0) {
+    }
+
+    UnrolledList(const UnrolledList &list) : UnrolledList() {
+        for (const T &value : list) {
+            push_back(value);
+        }
+    }
+
+    UnrolledList& operator=(const UnrolledList &list) {
+        if (&list == this) {
+            return *this;
+        }
+        UnrolledList copy(list);
+        swap(copy);
+        return *this;
+    }
+
+    ~UnrolledList() {
+        clear();
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        Node* node = tail_;
+        if (node == nullptr || node->count() == kNodeCapacity) {
+            node = new_node(0);
+            try {
+                new (node->slot(0)) T(std::forward<Args>(args)...);
+            } catch (...) {
+                delete_node(node);
+                throw;
+            }
+            link_after(node, tail_);
+        } else if (node->end == kNodeCapacity) {
+            // args may refer to an element the shift moves.
+            T value(std::forward<Args>(args)...);
+            shift_to(node, 0);
+            new (node->slot(node->end)) T(std::move(value));
+        } else {
+            new (node->slot(node->end)) T(std::forward<Args>(args)...);
+        }
+        ++node->end;
+        ++size_;
+        return *node->slot(node->end - 1);
+    }
+
+    template <typename... Args>
+    T& emplace_front(Args&&... args) {
+        Node* node = head_;
+        if (node == nullptr || node->count() == kNodeCapacity) {
+            node = new_node(kNodeCapacity);
+            try {
+                new (node->slot(kNodeCapacity - 1)) T(std::forward<Args>(args)...);
+            } catch (...) {
+                delete_node(node);
+                throw;
+            }
+            link_after(node, nullptr);
+        } else if (node->begin == 0) {
+            T value(std::forward<Args>(args)...);
+            shift_to(node, kNodeCapacity - node->count());
+            new (node->slot(node->begin - 1)) T(std::move(value));
+        } else {
+            new (node->slot(node->begin - 1)) T(std::forward<Args>(args)...);
+        }
+        --node->begin;
+        ++size_;
+        return *node->slot(node->begin);
+    }
+
+    void push_back(const T &value) {
+        emplace_back(value);
+    }
+
+    void push_back(T &&value) {
+        emplace_back(std::move(value));
+    }
+
+    void push_front(const T &value) {
+        emplace_front(value);
+    }
+
+    void push_front(T &&value) {
+        emplace_front(std::move(value));
+    }
+
+    void pop_back() {
+        std::destroy_at(tail_->slot(--tail_->end));
+        if (tail_->count() == 0) {
+            unlink(tail_);
+        }
+        --size_;
+    }
+
+    void pop_front() {
+        std::destroy_at(head_->slot(head_->begin++));
+        if (head_->count() == 0) {
+            unlink(head_);
+        }
+        --size_;
+    }
+
+    // Inserts before position and returns an iterator to the new element.
+    template <typename... Args>
+    iterator emplace(const_iterator position, Args&&... args) {
+        if (position.node_ == nullptr) {
+            emplace_back(std::forward<Args>(args)...);
+            return iterator(this, tail_, tail_->end - 1);
+        }
+        T value(std::forward<Args>(args)...);
+        Node* node = position.node_;
+        size_t offset = position.slot_ - node->begin;
+        if (node->count() == kNodeCapacity) {
+            split(node);
+            if (offset > node->count()) {
+                offset -= node->count();
+                node = node->next;
+            }
+        }
+        size_t slot = node->begin + offset;
+        if (node->end < kNodeCapacity) {
+            move_slots(node, slot, node->end - slot, node, slot + 1);
+            ++node->end;
+        } else {
+            move_slots(node, node->begin, offset, node, node->begin - 1);
+            --node->begin;
+            --slot;
+        }
+        new (node->slot(slot)) T(std::move(value));
+        ++size_;
+        return iterator(this, node, slot);
+    }
+
+    iterator insert(const_iterator position, const T &value) {
+        return emplace(position, value);
+    }
+
+    iterator insert(const_iterator position, T &&value) {
+        return emplace(position, std::move(value));
+    }
+
+    // Erases the element at position and returns an iterator to the next one.
+    iterator erase(const_iterator position) {
+        Node* node = position.node_;
+        size_t offset = position.slot_ - node->begin;
+        std::destroy_at(node->slot(position.slot_));
+        if (offset < node->count() / 2) {
+            move_slots(node, node->begin, offset, node, node->begin + 1);
+            ++node->begin;
+        } else {
+            move_slots(node, position.slot_ + 1, node->end - position.slot_ - 1, node,
+                       position.slot_);
+            --node->end;
+        }
+        --size_;
+
+        if (node->count() == 0) {
+            Node* next = node->next;
+            unlink(node);
+            return iterator(this, next, next != nullptr ? next->begin : 0);
+        }
+        Node* next = node->next;
+        if (next != nullptr && node->count() < kNodeCapacity / 2 &&
+            node->count() + next->count() <= kNodeCapacity) {
+            shift_to(node, 0);
+            move_slots(next, next->begin, next->count(), node, node->end);
+            node->end += next->count();
+            unlink(next);
+        }
+        if (offset == node->count()) {
+            return iterator(this, node->next, node->next != nullptr ? node->next->begin : 0);
+        }
+        return iterator(this, node, node->begin + offset);
+    }
+
+    void clear() {
+        while (head_ != nullptr) {
+            Node* next = head_->next;
+            std::destroy(head_->slot(head_->begin), head_->slot(head_->end));
+            delete_node(head_);
+            head_ = next;
+        }
+        tail_ = nullptr;
+        size_ = 0;
+    }
+
+    void swap(UnrolledList &list) {
+        std::swap(head_, list.head_);
+        std::swap(tail_, list.tail_);
+        std::swap(size_, list.size_);
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    T& front() {
+        return *head_->slot(head_->begin);
+    }
+
+    const T& front() const {
+        return *head_->slot(head_->begin);
+    }
+
+    T& back() {
+        return *tail_->slot(tail_->end - 1);
+    }
+
+    const T& back() const {
+        return *tail_->slot(tail_->end - 1);
+    }
+
+    iterator begin() {
+        return iterator(this, head_, head_ != nullptr ? head_->begin : 0);
+    }
+
+    const_iterator begin() const {
+        return const_iterator(this, head_, head_ != nullptr ? head_->begin : 0);
+    }
+
+    iterator end() {
+        return iterator(this, nullptr, 0);
+    }
+
+    const_iterator end() const {
+        return const_iterator(this, nullptr, 0);
+    }
+};
@@ -1,41 +1,130 @@
+#pragma once
+
+#include "relocation.h"
+#include "thread_pool.h"
+#include "vector_stats.h"
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <cstddef>
+#include <cstring>
+#include <functional>
 #include <memory>
+#include <type_traits>
 #include <utility>
 
-template <typename T>
+// Growth policies: next capacity for a full vector of the given capacity.
+struct DoublingGrowth {
+    static size_t next(size_t capacity) {
+        return capacity ? capacity * 2 : 1;
+    }
+};
+
+struct HalfGrowth {
+    static size_t next(size_t capacity) {
+        return capacity > 1 ? capacity + capacity / 2 : capacity + 1;
+    }
+};
+
+template <size_t Step>
+struct FixedGrowth {
+    static_assert(Step > 0);
+
+    static size_t next(size_t capacity) {
+        return capacity + Step;
+    }
+};
+
+// Allocators that can resize a block in place (see ReallocAllocator) expose
+// reallocate(ptr, old_count, new_count).
+template <typename Alloc, typename = void>
+struct HasReallocate : std::false_type {};
+
+template <typename Alloc>
+struct HasReallocate<Alloc, std::void_t<decltype(std::declval<Alloc&>().reallocate(
+                                std::declval<typename Alloc::value_type*>(), size_t(), size_t()))>>
+    : std::true_type {};
+
+// Raw storage for capacity elements of T. It does not know which slots hold
+// live objects, the owning container does.
+template <typename T, typename Alloc = std::allocator<T>>
+struct VectorMemory {
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    // Bulk operations touching at least twice this many bytes are split
+    // across ThreadPool::Global(). Each thread initializes its own range, so
+    // fresh pages are first touched (and placed) by the thread that owns them.
+    static constexpr size_t kParallelBytes = 4 << 20;
+
+    // Only trivially copyable elements are built on other threads. A
+    // constructor or destructor that merely cannot throw may still touch
+    // shared state, such as a SharedPtr's reference count.
+    static constexpr bool kParallel = std::is_trivially_copyable_v<T>;
+
+    char *bytes;
+    size_t capacity;
+    Alloc allocator;
+    VectorMemory(const Alloc &allocator = Alloc());
+    VectorMemory(size_t capacity, const Alloc &allocator = Alloc());
+    template <typename Body>
+    static void for_each_chunk(size_t count, bool parallel, Body body);
+    void construct(size_t start, size_t count);
+    void copy(const VectorMemory &memory, size_t count);
+    void fill(size_t start, size_t count, const T &value);
+    void relocate(VectorMemory &memory, size_t count);
+    void grow(size_t capacity, size_t count);
+    void destroy(size_t start, size_t count);
+    void swap(VectorMemory &memory);
+    T& operator[](size_t index);
+    const T& operator[](size_t index) const;
+    T* begin();
+    const T* begin() const;
+    ~VectorMemory();
+};
+
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
 class Vector {
-    struct VectorMemory {
-        char *bytes;
-        size_t capacity;
-        VectorMemory();
-        VectorMemory(size_t capacity);
-        void construct(size_t start, size_t count);
-        void copy(const VectorMemory &memory, size_t count);
-        void move(const VectorMemory &memory, size_t count);
-        void destroy(size_t start, size_t count);
-        void swap(VectorMemory &memory);
-        T& operator[](size_t index);
-        const T& operator[](size_t index) const;
-        T* begin();
-        const T* begin() const;
-        ~VectorMemory();
-    };
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using VectorMemory = ::VectorMemory<T, Alloc>;
+
     VectorMemory values;
     size_t count;
 
+    template <typename It>
+    void insert_range(size_t index, It first, size_t n);
+    template <typename It>
+    void insert_input_range(size_t index, It first, It last);
+
 public:
-    Vector();
-    Vector(size_t size);
+    using allocator_type = Alloc;
+
+    Vector(const Alloc &allocator = Alloc());
+    Vector(size_t size, const Alloc &allocator = Alloc());
+    Vector(size_t size, const T &value, const Alloc &allocator = Alloc());
     Vector(const Vector& vector);
     Vector& operator=(const Vector& vector);
     void reserve(size_t size);
+    void shrink_to_fit();
     void resize(size_t size);
+    void resize(size_t size, const T &value);
+    void resize_for_overwrite(size_t size);
+    T* append_uninitialized(size_t n);
     void clear();
     void push_back(const T &value);
     void push_back(T &&value);
+    template <typename... Args>
+    T& emplace_back(Args&&... args);
+    template <typename... Args>
+    T* emplace(const T *position, Args&&... args);
+    template <typename It>
+    void assign(It first, It last);
+    template <typename It>
+    void append_range(It first, It last);
+    template <typename It>
+    T* insert(const T *position, It first, It last);
+    T* erase(const T *first, const T *last);
     void pop_back();
-    void swap(Vector<T> &vector);
+    void swap(Vector &vector);
     size_t size() const;
     size_t capacity() const;
     T* begin();
@@ -44,49 +133,104 @@ public:
     const T* end() const;
     T& operator[](size_t index);
     const T& operator[](size_t index) const;
+    Alloc get_allocator() const;
     ~Vector();
 };
 
-template <typename T>
-Vector<T>::VectorMemory::VectorMemory() {
+template <typename T, typename Alloc>
+VectorMemory<T, Alloc>::VectorMemory(const Alloc &allocator) : allocator(allocator) {
     bytes = nullptr;
     capacity = 0;
 }
 
-template <typename T>
-Vector<T>::VectorMemory::VectorMemory(size_t capacity) {
+template <typename T, typename Alloc>
+VectorMemory<T, Alloc>::VectorMemory(size_t capacity, const Alloc &allocator)
+    : allocator(allocator) {
     this->capacity = capacity;
-    this->bytes = new char[capacity * sizeof(T)];
+    this->bytes = reinterpret_cast<char*>(AllocTraits::allocate(this->allocator, capacity));
+    VectorStats::OnAllocate<T>(capacity);
 }
 
-template <typename T>
-void Vector<T>::VectorMemory::construct(size_t start, size_t count) {
-    std::uninitialized_value_construct_n(reinterpret_cast<T*>(bytes) + start, count);
+// Calls body(begin, end) over [0, count), in parallel when allowed and the
+// range is large enough. Only operations that cannot throw and touch nothing
+// but their own range may run in parallel.
+template <typename T, typename Alloc>
+template <typename Body>
+void VectorMemory<T, Alloc>::for_each_chunk(size_t count, bool parallel, Body body) {
+    size_t min_chunk = kParallelBytes / sizeof(T) + 1;
+    if (!parallel || count < 2 * min_chunk) {
+        body(size_t(0), count);
+        return;
+    }
+    ThreadPool::Global().ParallelFor(count, min_chunk, body);
 }
 
-template <typename T>
-void Vector<T>::VectorMemory::copy(const VectorMemory &memory, size_t count) {
-    std::uninitialized_copy_n(reinterpret_cast<T*>(memory.bytes), count,
-                              reinterpret_cast<T*>(bytes));
+template <typename T, typename Alloc>
+void VectorMemory<T, Alloc>::construct(size_t start, size_t count) {
+    T *data = reinterpret_cast<T*>(bytes) + start;
+    for_each_chunk(count, kParallel && std::is_nothrow_default_constructible_v<T>,
+                   [data](size_t begin, size_t end) {
+                       std::uninitialized_value_construct_n(data + begin, end - begin);
+                   });
 }
 
-template <typename T>
-void Vector<T>::VectorMemory::move(const VectorMemory &memory, size_t count) {
-    std::uninitialized_move_n(reinterpret_cast<T*>(memory.bytes), count,
-                              reinterpret_cast<T*>(bytes));
+template <typename T, typename Alloc>
+void VectorMemory<T, Alloc>::copy(const VectorMemory &memory, size_t count) {
+    const T *from = reinterpret_cast<const T*>(memory.bytes);
+    T *to = reinterpret_cast<T*>(bytes);
+    for_each_chunk(count, kParallel, [from, to](size_t begin, size_t end) {
+        std::uninitialized_copy_n(from + begin, end - begin, to + begin);
+    });
 }
 
-template <typename T>
-void Vector<T>::VectorMemory::destroy(size_t start, size_t count) {
-    if (count == 1) {
-        std::destroy_at(reinterpret_cast<T*>(bytes) + start);
-    } else {
-        std::destroy_n(reinterpret_cast<T*>(bytes) + start, count);
+template <typename T, typename Alloc>
+void VectorMemory<T, Alloc>::fill(size_t start, size_t count, const T &value) {
+    T *data = reinterpret_cast<T*>(bytes) + start;
+    for_each_chunk(count, kParallel, [data, &value](size_t begin, size_t end) {
+        std::uninitialized_fill_n(data + begin, end - begin, value);
+    });
+}
+
+// Moves count elements out of memory into this block; the source elements are
+// dead afterwards and must not be destroyed again.
+template <typename T, typename Alloc>
+void VectorMemory<T, Alloc>::relocate(VectorMemory &memory, size_t count) {
+    UninitializedRelocateN(reinterpret_cast<T*>(memory.bytes), count,
+                           reinterpret_cast<T*>(bytes));
+}
+
+// Moves the block to the given capacity, larger or smaller, keeping the first
+// count elements. Trivially relocatable elements are left to the allocator's
+// reallocate when it has one, which can extend the block without copying.
+template <typename T, typename Alloc>
+void VectorMemory<T, Alloc>::grow(size_t capacity, size_t count) {
+    if constexpr (HasReallocate<Alloc>::value && IsTriviallyRelocatableV<T>) {
+        if (bytes != nullptr) {
+            bytes = reinterpret_cast<char*>(
+                allocator.reallocate(reinterpret_cast<T*>(bytes), this->capacity, capacity));
+            VectorStats::OnResizeBlock<T>(this->capacity, capacity);
+            VectorStats::OnReallocate<T>(0);
+            this->capacity = capacity;
+            return;
+        }
+    }
+    VectorMemory tmp(capacity, allocator);
+    tmp.relocate(*this, count);
+    tmp.swap(*this);
+    if (tmp.bytes != nullptr) {
+        VectorStats::OnReallocate<T>(count);
     }
 }
 
-template <typename T>
-void Vector<T>::VectorMemory::swap(VectorMemory &memory) {
+template <typename T, typename Alloc>
+void VectorMemory<T, Alloc>::destroy(size_t start, size_t count) {
+    // Elements that may run in parallel are trivially destructible, so
+    // destruction always stays on this thread.
+    std::destroy_n(reinterpret_cast<T*>(bytes) + start, count);
+}
+
+template <typename T, typename Alloc>
+void VectorMemory<T, Alloc>::swap(VectorMemory &memory) {
     char *tmpBytes = bytes;
     bytes = memory.bytes;
     memory.bytes = tmpBytes;
@@ -94,74 +238,111 @@ void Vector<T>::VectorMemory::swap(VectorMemory &memory) {
     size_t tmpCapacity = capacity;
     capacity = memory.capacity;
     memory.capacity = tmpCapacity;
+
+    std::swap(allocator, memory.allocator);
 }
 
-template <typename T>
-T& Vector<T>::VectorMemory::operator[](size_t index) {
+template <typename T, typename Alloc>
+T& VectorMemory<T, Alloc>::operator[](size_t index) {
     return reinterpret_cast<T*>(bytes)[index];
 }
 
-template <typename T>
-const T& Vector<T>::VectorMemory::operator[](size_t index) const {
+template <typename T, typename Alloc>
+const T& VectorMemory<T, Alloc>::operator[](size_t index) const {
     return reinterpret_cast<const T*>(bytes)[index];
 }
 
-template <typename T>
-T* Vector<T>::VectorMemory::begin() {
+template <typename T, typename Alloc>
+T* VectorMemory<T, Alloc>::begin() {
     return reinterpret_cast<T*>(bytes);
 }
 
-template <typename T>
-const T* Vector<T>::VectorMemory::begin() const {
+template <typename T, typename Alloc>
+const T* VectorMemory<T, Alloc>::begin() const {
     return reinterpret_cast<const T*>(bytes);
 }
 
-template <typename T>
-Vector<T>::VectorMemory::~VectorMemory() {
-    delete[] bytes;
+template <typename T, typename Alloc>
+VectorMemory<T, Alloc>::~VectorMemory() {
+    if (bytes != nullptr) {
+        AllocTraits::deallocate(allocator, reinterpret_cast<T*>(bytes), capacity);
+        VectorStats::OnFree<T>(capacity);
+    }
 }
 
-template <typename T>
-Vector<T>::Vector() {
+template <typename T, typename Alloc, typename Growth>
+Vector<T, Alloc, Growth>::Vector(const Alloc &allocator) : values(allocator) {
     count = 0;
 }
 
-template <typename T>
-Vector<T>::Vector(size_t size) : values(size) {
+template <typename T, typename Alloc, typename Growth>
+Vector<T, Alloc, Growth>::Vector(size_t size, const Alloc &allocator) : values(size, allocator) {
     values.construct(0, size);
     count = size;
+    VectorStats::OnResize<T>(0, count);
+}
+
+template <typename T, typename Alloc, typename Growth>
+Vector<T, Alloc, Growth>::Vector(size_t size, const T &value, const Alloc &allocator)
+    : values(size, allocator) {
+    values.fill(0, size, value);
+    count = size;
+    VectorStats::OnResize<T>(0, count);
 }
 
-template <typename T>
-Vector<T>::Vector(const Vector& vector) : values(vector.count) {
+template <typename T, typename Alloc, typename Growth>
+Vector<T, Alloc, Growth>::Vector(const Vector& vector)
+    : values(vector.count,
+             AllocTraits::select_on_container_copy_construction(vector.values.allocator)) {
     values.copy(vector.values, vector.count);
     count = vector.count;
+    VectorStats::OnResize<T>(0, count);
 }
 
-template <typename T>
-Vector<T>& Vector<T>::operator=(const Vector& vector) {
+// The copy goes into this vector's own allocator unless Alloc asks for it to
+// propagate on copy assignment, so a vector backed by a long-lived arena
+// never picks up a shorter-lived one from the source.
+template <typename T, typename Alloc, typename Growth>
+Vector<T, Alloc, Growth>& Vector<T, Alloc, Growth>::operator=(const Vector& vector) {
     if (&vector == this) {
         return *this;
     }
-    Vector<T> copy(vector);
-    swap(copy);
+    VectorMemory memory(vector.count,
+                        AllocTraits::propagate_on_container_copy_assignment::value
+                            ? vector.values.allocator
+                            : values.allocator);
+    memory.copy(vector.values, vector.count);
+    clear();
+    values.swap(memory);
+    count = vector.count;
+    VectorStats::OnResize<T>(0, count);
     return *this;
 }
 
-template <typename T>
-void Vector<T>::reserve(size_t size) {
+template <typename T, typename Alloc, typename Growth>
+void Vector<T, Alloc, Growth>::reserve(size_t size) {
     if (size <= values.capacity)
         return;
 
-    VectorMemory tmp(size);
-    tmp.move(values, count);
-    values.destroy(0, count);
-    tmp.swap(values);
+    values.grow(size, count);
 }
 
-template <typename T>
+// Drops the unused capacity, releasing the block entirely when empty.
+template <typename T, typename Alloc, typename Growth>
+void Vector<T, Alloc, Growth>::shrink_to_fit() {
+    if (count == values.capacity)
+        return;
 
-void Vector<T>::resize(size_t size) {
+    if (count == 0) {
+        VectorMemory empty(values.allocator);
+        empty.swap(values);
+        return;
+    }
+    values.grow(count, count);
+}
+
+template <typename T, typename Alloc, typename Growth>
+void Vector<T, Alloc, Growth>::resize(size_t size) {
     reserve(size);
 
     if (size > count) {
@@ -170,42 +351,227 @@ void Vector<T>::resize(size_t size) {
         values.destroy(size, count - size);
     }
 
+    VectorStats::OnResize<T>(count, size);
+    count = size;
+}
+
+template <typename T, typename Alloc, typename Growth>
+void Vector<T, Alloc, Growth>::resize(size_t size, const T &value) {
+    reserve(size);
+
+    if (size > count) {
+        values.fill(count, size - count, value);
+    } else if (size < count) {
+        values.destroy(size, count - size);
+    }
+
+    VectorStats::OnResize<T>(count, size);
     count = size;
 }
 
-template <typename T>
-void Vector<T>::clear() {
+// Like resize, but new elements are left with indeterminate values for the
+// caller to overwrite (e.g. with read()). Only for implicit-lifetime types,
+// whose objects need no constructor call to exist.
+template <typename T, typename Alloc, typename Growth>
+void Vector<T, Alloc, Growth>::resize_for_overwrite(size_t size) {
+    static_assert(std::is_trivially_default_constructible_v<T> &&
+                  std::is_trivially_destructible_v<T>,
+                  "resize_for_overwrite needs an implicit-lifetime type");
+    reserve(size);
+    VectorStats::OnResize<T>(count, size);
+    count = size;
+}
+
+// Adds n elements with indeterminate values and returns a pointer to the
+// first one. Growth is amortized like push_back.
+template <typename T, typename Alloc, typename Growth>
+T* Vector<T, Alloc, Growth>::append_uninitialized(size_t n) {
+    static_assert(std::is_trivially_default_constructible_v<T> &&
+                  std::is_trivially_destructible_v<T>,
+                  "append_uninitialized needs an implicit-lifetime type");
+    if (count + n > values.capacity) {
+        size_t next = Growth::next(values.capacity);
+        reserve(next > count + n ? next : count + n);
+    }
+    T *appended = values.begin() + count;
+    VectorStats::OnResize<T>(count, count + n);
+    count += n;
+    return appended;
+}
+
+template <typename T, typename Alloc, typename Growth>
+void Vector<T, Alloc, Growth>::clear() {
     values.destroy(0, count);
+    VectorStats::OnResize<T>(count, 0);
     count = 0;
 }
 
-template <typename T>
-void Vector<T>::push_back(const T &value) {
+template <typename T, typename Alloc, typename Growth>
+void Vector<T, Alloc, Growth>::push_back(const T &value) {
+    emplace_back(value);
+}
+
+template <typename T, typename Alloc, typename Growth>
+void Vector<T, Alloc, Growth>::push_back(T &&value) {
+    emplace_back(std::move(value));
+}
+
+// When the vector is full the new element is built before growing, since
+// args may refer to elements that growing would move.
+template <typename T, typename Alloc, typename Growth>
+template <typename... Args>
+T& Vector<T, Alloc, Growth>::emplace_back(Args&&... args) {
+    T *element;
     if (count == values.capacity) {
-        reserve(count ? count * 2 : 1);
+        T value(std::forward<Args>(args)...);
+        reserve(Growth::next(values.capacity));
+        element = new (values.begin() + count) T(std::move(value));
+    } else {
+        element = new (values.begin() + count) T(std::forward<Args>(args)...);
     }
-    new (reinterpret_cast<T*>(values.bytes) + count) T(value);
+    VectorStats::OnResize<T>(count, count + 1);
     count++;
+    return *element;
 }
 
-template <typename T>
-void Vector<T>::push_back(T &&value) {
-    if (count == values.capacity) {
-        reserve(count ? count * 2 : 1);
+template <typename T, typename Alloc, typename Growth>
+template <typename... Args>
+T* Vector<T, Alloc, Growth>::emplace(const T *position, Args&&... args) {
+    size_t index = position - values.begin();
+    if (index == count) {
+        return &emplace_back(std::forward<Args>(args)...);
     }
+    T value(std::forward<Args>(args)...);
+    insert_range(index, std::make_move_iterator(&value), 1);
+    return values.begin() + index;
+}
 
-    new (reinterpret_cast<T*>(values.bytes) + count) T(std::move(value));
-    count++;
+// Inserts n elements read from first before index, growing at most once.
+// Trivially relocatable tails are shifted with one memmove, others are
+// appended and rotated into place.
+template <typename T, typename Alloc, typename Growth>
+template <typename It>
+void Vector<T, Alloc, Growth>::insert_range(size_t index, It first, size_t n) {
+    if (n == 0)
+        return;
+
+    if constexpr (std::is_pointer_v<It>) {
+        std::less<const T*> less;
+        const T *source = first;
+        if (!less(source, values.begin()) && less(source, values.begin() + count)) {
+            // The source lives in this vector and would move under our feet.
+            Vector copy(values.allocator);
+            copy.insert_range(0, first, n);
+            insert_range(index, std::make_move_iterator(copy.begin()), n);
+            return;
+        }
+    }
+
+    if (count + n > values.capacity) {
+        size_t next = Growth::next(values.capacity);
+        reserve(next > count + n ? next : count + n);
+    }
+
+    T *position = values.begin() + index;
+    size_t tail = count - index;
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        if (tail != 0) {
+            std::memmove(static_cast<void*>(position + n), static_cast<void*>(position),
+                         tail * sizeof(T));
+        }
+        try {
+            std::uninitialized_copy_n(first, n, position);
+        } catch (...) {
+            if (tail != 0) {
+                std::memmove(static_cast<void*>(position), static_cast<void*>(position + n),
+                             tail * sizeof(T));
+            }
+            throw;
+        }
+    } else {
+        T *end = values.begin() + count;
+        std::uninitialized_copy_n(first, n, end);
+        std::rotate(position, end, end + n);
+    }
+    VectorStats::OnResize<T>(count, count + n);
+    count += n;
 }
 
-template <typename T>
-void Vector<T>::pop_back() {
+// Single-pass iterators cannot be measured up front, so they are buffered.
+template <typename T, typename Alloc, typename Growth>
+template <typename It>
+void Vector<T, Alloc, Growth>::insert_input_range(size_t index, It first, It last) {
+    using Category = typename std::iterator_traits<It>::iterator_category;
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+        insert_range(index, first, std::distance(first, last));
+    } else {
+        Vector buffer(values.allocator);
+        for (; first != last; ++first) {
+            buffer.emplace_back(*first);
+        }
+        insert_range(index, std::make_move_iterator(buffer.begin()), buffer.count);
+    }
+}
+
+template <typename T, typename Alloc, typename Growth>
+template <typename It>
+void Vector<T, Alloc, Growth>::assign(It first, It last) {
+    clear();
+    using Category = typename std::iterator_traits<It>::iterator_category;
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+        size_t n = std::distance(first, last);
+        if (n > values.capacity) {
+            VectorMemory empty(values.allocator);
+            empty.swap(values);
+        }
+    }
+    insert_input_range(0, first, last);
+}
+
+template <typename T, typename Alloc, typename Growth>
+template <typename It>
+void Vector<T, Alloc, Growth>::append_range(It first, It last) {
+    insert_input_range(count, first, last);
+}
+
+template <typename T, typename Alloc, typename Growth>
+template <typename It>
+T* Vector<T, Alloc, Growth>::insert(const T *position, It first, It last) {
+    size_t index = position - values.begin();
+    insert_input_range(index, first, last);
+    return values.begin() + index;
+}
+
+template <typename T, typename Alloc, typename Growth>
+T* Vector<T, Alloc, Growth>::erase(const T *first, const T *last) {
+    T *from = values.begin() + (first - values.begin());
+    size_t n = last - first;
+    if (n == 0)
+        return from;
+
+    T *end = values.begin() + count;
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        std::destroy_n(from, n);
+        std::memmove(static_cast<void*>(from), static_cast<void*>(from + n),
+                     (end - from - n) * sizeof(T));
+    } else {
+        std::move(from + n, end, from);
+        std::destroy(end - n, end);
+    }
+    VectorStats::OnResize<T>(count, count - n);
+    count -= n;
+    return from;
+}
+
+template <typename T, typename Alloc, typename Growth>
+void Vector<T, Alloc, Growth>::pop_back() {
     values.destroy(count - 1, 1);
+    VectorStats::OnResize<T>(count, count - 1);
     count--;
 }
 
-template <typename T>
-void Vector<T>::swap(Vector<T> &vector) {
+template <typename T, typename Alloc, typename Growth>
+void Vector<T, Alloc, Growth>::swap(Vector &vector) {
     values.swap(vector.values);
 
     size_t tmp = count;
@@ -213,47 +579,53 @@ void Vector<T>::swap(Vector<T> &vector) {
     vector.count = tmp;
 }
 
-template <typename T>
-size_t Vector<T>::size() const {
+template <typename T, typename Alloc, typename Growth>
+size_t Vector<T, Alloc, Growth>::size() const {
     return count;
 }
 
-template <typename T>
-size_t Vector<T>::capacity() const {
+template <typename T, typename Alloc, typename Growth>
+size_t Vector<T, Alloc, Growth>::capacity() const {
     return values.capacity;
 }
 
-template <typename T>
-T* Vector<T>::begin() {
+template <typename T, typename Alloc, typename Growth>
+T* Vector<T, Alloc, Growth>::begin() {
     return values.begin();
 }
 
-template <typename T>
-const T*  Vector<T>::begin() const {
+template <typename T, typename Alloc, typename Growth>
+const T*  Vector<T, Alloc, Growth>::begin() const {
     return values.begin();
 }
 
-template <typename T>
-T* Vector<T>::end() {
+template <typename T, typename Alloc, typename Growth>
+T* Vector<T, Alloc, Growth>::end() {
     return values.begin() + count;
 }
 
-template <typename T>
-const T* Vector<T>::end() const {
+template <typename T, typename Alloc, typename Growth>
+const T* Vector<T, Alloc, Growth>::end() const {
     return values.begin() + count;
 }
 
-template <typename T>
-T& Vector<T>::operator[](size_t index) {
+template <typename T, typename Alloc, typename Growth>
+T& Vector<T, Alloc, Growth>::operator[](size_t index) {
     return values[index];
 }
 
-template <typename T>
-const T& Vector<T>::operator[](size_t index) const {
+template <typename T, typename Alloc, typename Growth>
+const T& Vector<T, Alloc, Growth>::operator[](size_t index) const {
     return values[index];
 }
 
-template <typename T>
-Vector<T>::~Vector() {
+template <typename T, typename Alloc, typename Growth>
+Alloc Vector<T, Alloc, Growth>::get_allocator() const {
+    return values.allocator;
+}
+
+template <typename T, typename Alloc, typename Growth>
+Vector<T, Alloc, Growth>::~Vector() {
     values.destroy(0, count);
+    VectorStats::OnResize<T>(count, 0);
 }  // nice
@@ -0,0 +1,593 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Bump-pointer region. Allocations are never freed individually, everything
+// is returned at once by Release() or the destructor.
+class MonotonicArena {
+    struct Block {
+        Block* next;
+        size_t size;
+    };
+
+public:
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+    explicit MonotonicArena(size_t block_size = kDefaultBlockSize) : block_size_(block_size) {
+    }
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena() {
+        Release();
+    }
+
+    void* Allocate(size_t bytes, size_t alignment) {
+        uintptr_t aligned = (current_ + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        if (blocks_ == nullptr || aligned + bytes > end_) {
+            NewBlock(bytes + alignment);
+            aligned = (current_ + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        }
+        current_ = aligned + bytes;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    void Release() {
+        while (blocks_ != nullptr) {
+            Block* next = blocks_->next;
+            ::operator delete(blocks_);
+            blocks_ = next;
+        }
+        current_ = end_ = 0;
+    }
+
+private:
+    void NewBlock(size_t min_size) {
+        size_t size = sizeof(Block) + (min_size > block_size_ ? min_size : block_size_);
+        Block* block = static_cast<Block*>(::operator new(size));
+        block->next = blocks_;
+        block->size = size;
+        blocks_ = block;
+        current_ = reinterpret_cast<uintptr_t>(block + 1);
+        end_ = reinterpret_cast<uintptr_t>(block) + size;
+    }
+
+    size_t block_size_;
+    Block* blocks_ = nullptr;
+    uintptr_t current_ = 0;
+    uintptr_t end_ = 0;
+};
+
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator(MonotonicArena& arena) : arena_(&arena) {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena_) {
+    }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) {
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const {
+        return arena_ == other.arena_;
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const {
+        return arena_ != other.arena_;
+    }
+
+private:
+    MonotonicArena* arena_;
+
+    template <typename U>
+    friend class ArenaAllocator;
+};
+
+// Power-of-two size classes from 16 bytes up to kMaxPooled, each with its own
+// free list. Chunks are carved from blocks that live until the pool dies;
+// larger requests go straight to the global heap.
+class SizeClassPool {
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    struct Block {
+        Block* next;
+    };
+
+public:
+    static constexpr size_t kMinClass = 16;
+    static constexpr size_t kMaxPooled = 64 * 1024;
+    static constexpr size_t kClassCount = 13;  // 16 .. 64K
+    static constexpr size_t kBlockSize = 256 * 1024;
+
+    SizeClassPool() = default;
+    SizeClassPool(const SizeClassPool&) = delete;
+    SizeClassPool& operator=(const SizeClassPool&) = delete;
+
+    ~SizeClassPool() {
+        while (blocks_ != nullptr) {
+            Block* next = blocks_->next;
+            ::operator delete(blocks_);
+            blocks_ = next;
+        }
+    }
+
+    void* Allocate(size_t bytes) {
+        if (bytes > kMaxPooled) {
+            return ::operator new(bytes);
+        }
+        size_t index = ClassIndex(bytes);
+        if (free_[index] == nullptr) {
+            Refill(index);
+        }
+        FreeNode* node = free_[index];
+        free_[index] = node->next;
+        return node;
+    }
+
+    void Deallocate(void* ptr, size_t bytes) {
+        if (bytes > kMaxPooled) {
+            ::operator delete(ptr);
+            return;
+        }
+        size_t index = ClassIndex(bytes);
+        FreeNode* node = static_cast<FreeNode*>(ptr);
+        node->next = free_[index];
+        free_[index] = node;
+    }
+
+private:
+    static size_t ClassIndex(size_t bytes) {
+        size_t index = 0;
+        size_t size = kMinClass;
+        while (size < bytes) {
+            size <<= 1;
+            ++index;
+        }
+        return index;
+    }
+
+    void Refill(size_t index) {
+        size_t chunk = kMinClass << index;
+        Block* block = static_cast<Block*>(::operator new(kBlockSize));
+        block->next = blocks_;
+        blocks_ = block;
+        // Chunks start at a kMinClass boundary so every class is 16-byte aligned.
+        char* begin = reinterpret_cast<char*>(block) + kMinClass;
+        char* end = reinterpret_cast<char*>(block) + kBlockSize;
+        for (char* ptr = begin; ptr + chunk <= end; ptr += chunk) {
+            FreeNode* node = reinterpret_cast<FreeNode*>(ptr);
+            node->next = free_[index];
+            free_[index] = node;
+        }
+    }
+
+    FreeNode* free_[kClassCount] = {};
+    Block* blocks_ = nullptr;
+};
+
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator(SizeClassPool& pool) : pool_(&pool) {
+    }
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) : pool_(other.pool_) {
+    }
+
+    T* allocate(size_t n) {
+        static_assert(alignof(T) <= SizeClassPool::kMinClass);
+        return static_cast<T*>(pool_->Allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) {
+        pool_->Deallocate(ptr, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const {
+        return pool_ == other.pool_;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>& other) const {
+        return pool_ != other.pool_;
+    }
+
+private:
+    SizeClassPool* pool_;
+
+    template <typename U>
+    friend class PoolAllocator;
+};
+
+// Global heap allocator returning blocks aligned to Alignment bytes, or to
+// alignof(T) if that is stricter, e.g. Vector<float, AlignedAllocator<float, 64>>
+// for cache-line aligned buffers that SIMD code can load with aligned loads.
+template <typename T, size_t Alignment = alignof(T)>
+class AlignedAllocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, "alignment must be a power of two");
+
+public:
+    using value_type = T;
+
+    static constexpr size_t kAlignment = Alignment > alignof(T) ? Alignment : alignof(T);
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {
+    }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(kAlignment)));
+    }
+
+    void deallocate(T* ptr, size_t) {
+        ::operator delete(ptr, std::align_val_t(kAlignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const {
+        return false;
+    }
+};
+
+// Anonymous page mappings, used by allocators that hand out whole pages.
+class PageMemory {
+public:
+    static size_t PageSize() {
+        static const size_t page_size = sysconf(_SC_PAGESIZE);
+        return page_size;
+    }
+
+    static size_t RoundUp(size_t bytes) {
+        size_t page_size = PageSize();
+        return (bytes + page_size - 1) & ~(page_size - 1);
+    }
+
+    static void* Map(size_t bytes) {
+        void* ptr = mmap(nullptr, RoundUp(bytes), PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    // Moves the mapping to a larger (or smaller) size. On Linux the kernel
+    // just rewires the page tables, elsewhere the pages are copied.
+    static void* Remap(void* ptr, size_t old_bytes, size_t new_bytes) {
+#ifdef __linux__
+        void* result = mremap(ptr, RoundUp(old_bytes), RoundUp(new_bytes), MREMAP_MAYMOVE);
+        if (result == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return result;
+#else
+        void* result = Map(new_bytes);
+        std::memcpy(result, ptr, old_bytes < new_bytes ? old_bytes : new_bytes);
+        Unmap(ptr, old_bytes);
+        return result;
+#endif
+    }
+
+    static void Unmap(void* ptr, size_t bytes) {
+        munmap(ptr, RoundUp(bytes));
+    }
+
+    // Transparent huge pages need 2 MiB aligned ranges, so huge mappings are
+    // sized in whole huge pages and trimmed to a huge page boundary.
+    static constexpr size_t kHugePageSize = 2 << 20;
+
+    static size_t RoundUpHuge(size_t bytes) {
+        return (bytes + kHugePageSize - 1) & ~(kHugePageSize - 1);
+    }
+
+    static void* MapHuge(size_t bytes) {
+        size_t size = RoundUpHuge(bytes);
+        char* raw = static_cast<char*>(Map(size + kHugePageSize));
+        char* aligned = reinterpret_cast<char*>(RoundUpHuge(reinterpret_cast<uintptr_t>(raw)));
+        if (aligned != raw) {
+            munmap(raw, aligned - raw);
+        }
+        munmap(aligned + size, raw + kHugePageSize - aligned);
+        AdviseHuge(aligned, size);
+        return aligned;
+    }
+
+    // Like Remap, but the result stays huge page aligned: a mapping that
+    // cannot grow where it is moves into a freshly reserved aligned range.
+    static void* RemapHuge(void* ptr, size_t old_bytes, size_t new_bytes) {
+        size_t old_size = RoundUpHuge(old_bytes);
+        size_t new_size = RoundUpHuge(new_bytes);
+        if (old_size == new_size) {
+            return ptr;
+        }
+#ifdef __linux__
+        void* result = mremap(ptr, old_size, new_size, 0);
+        if (result == MAP_FAILED) {
+            void* target = MapHuge(new_size);
+            result = mremap(ptr, old_size, new_size, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+            if (result == MAP_FAILED) {
+                munmap(target, new_size);
+                throw std::bad_alloc();
+            }
+        }
+#else
+        void* result = MapHuge(new_size);
+        std::memcpy(result, ptr, old_size < new_size ? old_size : new_size);
+        munmap(ptr, old_size);
+#endif
+        AdviseHuge(result, new_size);
+        return result;
+    }
+
+    static void UnmapHuge(void* ptr, size_t bytes) {
+        munmap(ptr, RoundUpHuge(bytes));
+    }
+
+    static void AdviseHuge(void* ptr, size_t bytes) {
+#ifdef MADV_HUGEPAGE
+        madvise(ptr, bytes, MADV_HUGEPAGE);
+#endif
+    }
+};
+
+// malloc-backed allocator for trivially copyable T that can grow a block in
+// place. Small blocks go through realloc, blocks of at least kMapThreshold
+// bytes are page mappings grown with mremap, so a huge vector never needs the
+// old and new buffers at the same time.
+template <typename T>
+class ReallocAllocator {
+    static_assert(std::is_trivially_copyable_v<T>, "blocks are moved with realloc/mremap");
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc cannot over-align");
+
+public:
+    using value_type = T;
+
+    static constexpr size_t kMapThreshold = 1 << 20;
+
+    ReallocAllocator() = default;
+
+    template <typename U>
+    ReallocAllocator(const ReallocAllocator<U>&) {
+    }
+
+    T* allocate(size_t n) {
+        size_t bytes = n * sizeof(T);
+        if (bytes >= kMapThreshold) {
+            return static_cast<T*>(PageMemory::Map(bytes));
+        }
+        void* ptr = std::malloc(bytes ? bytes : 1);
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(ptr);
+    }
+
+    T* reallocate(T* ptr, size_t old_n, size_t new_n) {
+        size_t old_bytes = old_n * sizeof(T);
+        size_t new_bytes = new_n * sizeof(T);
+        bool old_mapped = old_bytes >= kMapThreshold;
+        bool new_mapped = new_bytes >= kMapThreshold;
+        if (old_mapped && new_mapped) {
+            return static_cast<T*>(PageMemory::Remap(ptr, old_bytes, new_bytes));
+        }
+        if (!old_mapped && !new_mapped) {
+            void* result = std::realloc(ptr, new_bytes ? new_bytes : 1);
+            if (result == nullptr) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(result);
+        }
+        T* result = allocate(new_n);
+        std::memcpy(result, ptr, old_bytes < new_bytes ? old_bytes : new_bytes);
+        deallocate(ptr, old_n);
+        return result;
+    }
+
+    void deallocate(T* ptr, size_t n) {
+        size_t bytes = n * sizeof(T);
+        if (bytes >= kMapThreshold) {
+            PageMemory::Unmap(ptr, bytes);
+        } else {
+            std::free(ptr);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const ReallocAllocator<U>&) const {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const ReallocAllocator<U>&) const {
+        return false;
+    }
+};
+
+// Serves blocks of at least Threshold bytes from anonymous mappings backed by
+// transparent huge pages and smaller ones from the global heap. Threshold 0
+// puts every block on huge pages.
+template <typename T, size_t Threshold = PageMemory::kHugePageSize>
+class HugePageAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = HugePageAllocator<U, Threshold>;
+    };
+
+    HugePageAllocator() = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, Threshold>&) {
+    }
+
+    T* allocate(size_t n) {
+        size_t bytes = n * sizeof(T);
+        if (IsMapped(bytes)) {
+            return static_cast<T*>(PageMemory::MapHuge(bytes));
+        }
+        return std::allocator<T>().allocate(n);
+    }
+
+    // Only used for trivially relocatable T, see VectorMemory::grow.
+    T* reallocate(T* ptr, size_t old_n, size_t new_n) {
+        size_t old_bytes = old_n * sizeof(T);
+        size_t new_bytes = new_n * sizeof(T);
+        if (IsMapped(old_bytes) && IsMapped(new_bytes)) {
+            return static_cast<T*>(PageMemory::RemapHuge(ptr, old_bytes, new_bytes));
+        }
+        T* result = allocate(new_n);
+        std::memcpy(static_cast<void*>(result), static_cast<const void*>(ptr),
+                    old_bytes < new_bytes ? old_bytes : new_bytes);
+        deallocate(ptr, old_n);
+        return result;
+    }
+
+    void deallocate(T* ptr, size_t n) {
+        size_t bytes = n * sizeof(T);
+        if (IsMapped(bytes)) {
+            PageMemory::UnmapHuge(ptr, bytes);
+        } else {
+            std::allocator<T>().deallocate(ptr, n);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U, Threshold>&) const {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U, Threshold>&) const {
+        return false;
+    }
+
+private:
+    static bool IsMapped(size_t bytes) {
+        return bytes >= Threshold && bytes != 0;
+    }
+};
+
+// Slots for single objects of type T, bump-allocated from blocks of doubling
+// size taken from Alloc. Freed slots go on a free list and are handed out
+// again first; blocks go back to Alloc only when the pool dies. Not thread
+// safe: meant to be owned by one container, like List's node pool.
+template <typename T, typename Alloc = std::allocator<T>>
+class SlabPool {
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct Block {
+        Block* next;
+        size_t slots;
+    };
+
+    using SlotAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Slot>;
+    using SlotTraits = std::allocator_traits<SlotAlloc>;
+
+    // Leading slots of every block hold its Block header.
+    static constexpr size_t kHeaderSlots = (sizeof(Block) + sizeof(Slot) - 1) / sizeof(Slot);
+
+public:
+    static constexpr size_t kMinBlockSlots = 32;
+    static constexpr size_t kMaxBlockSlots = 4096;
+
+    explicit SlabPool(const Alloc& allocator = Alloc()) : allocator_(allocator) {
+    }
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    ~SlabPool() {
+        while (blocks_ != nullptr) {
+            Block* next = blocks_->next;
+            SlotTraits::deallocate(allocator_, reinterpret_cast<Slot*>(blocks_), blocks_->slots);
+            blocks_ = next;
+        }
+    }
+
+    // Uninitialized storage for one T.
+    T* Allocate() {
+        Slot* slot = free_;
+        if (slot != nullptr) {
+            free_ = slot->next;
+        } else {
+            if (next_ == end_) {
+                NewBlock();
+            }
+            slot = next_++;
+        }
+        return reinterpret_cast<T*>(slot->storage);
+    }
+
+    // ptr must come from this pool and hold no live object.
+    void Deallocate(T* ptr) {
+        Slot* slot = reinterpret_cast<Slot*>(ptr);
+        slot->next = free_;
+        free_ = slot;
+    }
+
+private:
+    void NewBlock() {
+        size_t slots = kHeaderSlots + block_slots_;
+        Slot* memory = SlotTraits::allocate(allocator_, slots);
+        Block* block = reinterpret_cast<Block*>(memory);
+        block->next = blocks_;
+        block->slots = slots;
+        blocks_ = block;
+        next_ = memory + kHeaderSlots;
+        end_ = memory + slots;
+        if (block_slots_ < kMaxBlockSlots) {
+            block_slots_ *= 2;
+        }
+    }
+
+    SlotAlloc allocator_;
+    Block* blocks_ = nullptr;
+    Slot* free_ = nullptr;
+    Slot* next_ = nullptr;
+    Slot* end_ = nullptr;
+    size_t block_slots_ = kMinBlockSlots;
+};
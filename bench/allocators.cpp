@@ -0,0 +1,49 @@
+#include "../Vector.cpp"
+#include "../allocators.h"
+#include "bench.h"
+
+#include <cstdlib>
+
+// Many short-lived vectors, as built while serving one request: each request
+// fills a few vectors with push_back and throws them all away.
+
+namespace {
+
+constexpr int kVectorsPerRequest = 16;
+constexpr int kElements = 200;
+
+template <typename MakeVector>
+void Requests(int requests, MakeVector make) {
+    for (int r = 0; r < requests; ++r) {
+        for (int v = 0; v < kVectorsPerRequest; ++v) {
+            auto values = make();
+            for (int i = 0; i < kElements; ++i) {
+                values.push_back(i);
+            }
+            DoNotOptimize(values[kElements - 1]);
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    int requests = 20000 / (argc > 1 ? std::atoi(argv[1]) : 1);
+
+    Report("global heap", Measure([&] {
+        Requests(requests, [] { return Vector<int>(); });
+    }));
+
+    Report("monotonic arena, released per request", Measure([&] {
+        MonotonicArena arena;
+        for (int r = 0; r < requests; ++r) {
+            Requests(1, [&] { return Vector<int, ArenaAllocator<int>>(ArenaAllocator<int>(arena)); });
+            arena.Release();
+        }
+    }));
+
+    Report("size-class pool", Measure([&] {
+        SizeClassPool pool;
+        Requests(requests, [&] { return Vector<int, PoolAllocator<int>>(PoolAllocator<int>(pool)); });
+    }));
+}
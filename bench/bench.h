@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+// Timing helpers for the benchmarks in this directory. Each benchmark is a
+// single translation unit with its own main, e.g.
+//
+//     g++ -std=c++17 -O2 -DNDEBUG bench/allocators.cpp -o allocators -lpthread
+//
+// and prints one line per case. Pass a number on the command line to scale
+// the sizes down for a quick run.
+
+// Best wall-clock time of body over a few runs, in milliseconds. setup runs
+// before each of them, outside the timed region.
+template <typename Setup, typename Body>
+double MeasureWithSetup(Setup &&setup, Body &&body, int repeats = 5) {
+    double best = 0;
+    for (int i = 0; i < repeats; ++i) {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = i == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+template <typename Body>
+double Measure(Body &&body, int repeats = 5) {
+    return MeasureWithSetup([] {}, body, repeats);
+}
+
+inline void Report(const char *name, double ms) {
+    std::printf("%-48s %10.2f ms\n", name, ms);
+}
+
+// Keeps the compiler from dropping a computation whose result is unused.
+template <typename T>
+void DoNotOptimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
@@ -0,0 +1,83 @@
+#include "../ConcurrentQueue.cpp"
+#include "../List.cpp"
+#include "bench.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Producer/consumer scaling of ConcurrentQueue against a List guarded by a
+// mutex, the work queue it replaces. A fixed number of items goes through the
+// queue with 1 to 64 threads on each side; consumers yield when they find the
+// queue empty.
+
+namespace {
+
+class LockedList {
+    List<size_t> list_;
+    std::mutex mutex_;
+
+public:
+    void push_back(size_t value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        list_.push_back(value);
+    }
+
+    bool pop_front(size_t &value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (list_.empty()) {
+            return false;
+        }
+        value = list_.front();
+        list_.pop_front();
+        return true;
+    }
+};
+
+template <typename Queue>
+void Pump(size_t total, int threads) {
+    Queue queue;
+    std::atomic<size_t> popped{0};
+    std::thread producers[64];
+    std::thread consumers[64];
+    for (int t = 0; t < threads; ++t) {
+        producers[t] = std::thread([&, t] {
+            for (size_t i = t; i < total; i += threads) {
+                queue.push_back(i);
+            }
+        });
+        consumers[t] = std::thread([&] {
+            size_t value;
+            size_t sum = 0;
+            while (popped.load(std::memory_order_relaxed) < total) {
+                if (queue.pop_front(value)) {
+                    sum += value;
+                    popped.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            DoNotOptimize(sum);
+        });
+    }
+    for (int t = 0; t < threads; ++t) {
+        producers[t].join();
+        consumers[t].join();
+    }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    size_t total = 2000000 / (argc > 1 ? std::atoi(argv[1]) : 1);
+
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        std::string suffix = ", " + std::to_string(threads) + " producers and consumers";
+        Report(("ConcurrentQueue" + suffix).c_str(),
+               Measure([&] { Pump<ConcurrentQueue<size_t>>(total, threads); }, 3));
+        Report(("List with mutex" + suffix).c_str(),
+               Measure([&] { Pump<LockedList>(total, threads); }, 3));
+    }
+}
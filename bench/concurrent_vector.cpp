@@ -0,0 +1,55 @@
+#include "../ConcurrentVector.cpp"
+#include "../Vector.cpp"
+#include "bench.h"
+
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Collectors appending from many threads: ConcurrentVector::push_back against
+// a Vector guarded by a mutex, with a fixed total number of elements split
+// across the threads.
+
+namespace {
+
+template <typename Append>
+void Spread(size_t total, int threads, Append append) {
+    std::thread workers[64];
+    for (int t = 0; t < threads; ++t) {
+        workers[t] = std::thread([=, &append] {
+            for (size_t i = t; i < total; i += threads) {
+                append(i);
+            }
+        });
+    }
+    for (int t = 0; t < threads; ++t) {
+        workers[t].join();
+    }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    size_t total = 4000000 / (argc > 1 ? std::atoi(argv[1]) : 1);
+
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        std::string suffix = ", " + std::to_string(threads) + " threads";
+
+        Report(("ConcurrentVector" + suffix).c_str(), Measure([&] {
+            ConcurrentVector<size_t> values;
+            Spread(total, threads, [&](size_t i) { values.push_back(i); });
+            DoNotOptimize(values[total - 1]);
+        }, 3));
+
+        Report(("Vector with mutex" + suffix).c_str(), Measure([&] {
+            Vector<size_t> values;
+            std::mutex mutex;
+            Spread(total, threads, [&](size_t i) {
+                std::lock_guard<std::mutex> lock(mutex);
+                values.push_back(i);
+            });
+            DoNotOptimize(values[total - 1]);
+        }, 3));
+    }
+}
@@ -0,0 +1,68 @@
+#include "../FlatMap.cpp"
+#include "bench.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+
+// FlatMap against std::map, a red-black tree, from 1K to 10M entries: bulk
+// build from unsorted input, then random lookups of present and absent keys.
+
+namespace {
+
+constexpr size_t kLookups = 1000000;
+
+void Run(size_t n) {
+    std::mt19937_64 gen(n);
+    Vector<std::pair<uint64_t, uint64_t>> entries;
+    for (size_t i = 0; i < n; ++i) {
+        entries.push_back({gen() | 1, i});
+    }
+    // Half the probes hit, half miss (present keys are all odd).
+    Vector<uint64_t> probes;
+    for (size_t i = 0; i < kLookups; ++i) {
+        probes.push_back(i % 2 ? entries[gen() % n].first : gen() & ~uint64_t(1));
+    }
+    std::string size = std::to_string(n) + " entries, ";
+
+    FlatMap<uint64_t, uint64_t> flat;
+    Report((size + "FlatMap build").c_str(), Measure([&] {
+        flat = FlatMap<uint64_t, uint64_t>(entries);
+    }, 3));
+    std::map<uint64_t, uint64_t> tree;
+    Report((size + "std::map build").c_str(), Measure([&] {
+        tree = std::map<uint64_t, uint64_t>();
+        for (size_t i = 0; i < n; ++i) {
+            tree.emplace(entries[i].first, entries[i].second);
+        }
+    }, 3));
+
+    Report((size + "FlatMap lookups").c_str(), Measure([&] {
+        uint64_t total = 0;
+        for (size_t i = 0; i < kLookups; ++i) {
+            const uint64_t *value = flat.find(probes[i]);
+            total += value != nullptr ? *value : 0;
+        }
+        DoNotOptimize(total);
+    }));
+    Report((size + "std::map lookups").c_str(), Measure([&] {
+        uint64_t total = 0;
+        for (size_t i = 0; i < kLookups; ++i) {
+            auto it = tree.find(probes[i]);
+            total += it != tree.end() ? it->second : 0;
+        }
+        DoNotOptimize(total);
+    }));
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    size_t scale = argc > 1 ? std::atoi(argv[1]) : 1;
+
+    for (size_t n = 1000; n <= 10000000; n *= 10) {
+        Run(std::max<size_t>(n / scale, 1));
+    }
+}
@@ -0,0 +1,82 @@
+#include "../List.cpp"
+#include "bench.h"
+
+#include <cstdlib>
+#include <list>
+
+// Queue-style churn on List, whose nodes come from a slab pool, against
+// std::list, which allocates every node on the heap.
+
+namespace {
+
+// A queue holding a steady backlog: every step pushes one element at the back
+// and pops one at the front.
+template <typename Queue>
+void Steady(Queue &queue, size_t backlog, size_t steps) {
+    for (size_t i = 0; i < backlog; ++i) {
+        queue.push_back(int(i));
+    }
+    for (size_t i = 0; i < steps; ++i) {
+        queue.push_back(int(i));
+        DoNotOptimize(queue.front());
+        queue.pop_front();
+    }
+    while (!queue.empty()) {
+        queue.pop_front();
+    }
+}
+
+// Bursts that fill the queue from empty and drain it again.
+template <typename Queue>
+void Bursts(Queue &queue, size_t burst, size_t steps) {
+    for (size_t done = 0; done < steps; done += burst) {
+        for (size_t i = 0; i < burst; ++i) {
+            queue.push_back(int(i));
+        }
+        while (!queue.empty()) {
+            DoNotOptimize(queue.front());
+            queue.pop_front();
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    size_t steps = 10000000 / (argc > 1 ? std::atoi(argv[1]) : 1);
+
+    Report("steady backlog of 1000, List", Measure([&] {
+        List<int> queue;
+        Steady(queue, 1000, steps);
+    }));
+    Report("steady backlog of 1000, List fed by splice", Measure([&] {
+        // Every element is pushed onto a producer list and spliced over, so
+        // each pop hands the node back to the producer's pool.
+        List<int> queue;
+        List<int> producer;
+        for (size_t i = 0; i < 1000; ++i) {
+            producer.push_back(int(i));
+        }
+        queue.splice(queue.end(), producer);
+        for (size_t i = 0; i < steps; ++i) {
+            producer.push_back(int(i));
+            queue.splice(queue.end(), producer);
+            DoNotOptimize(queue.front());
+            queue.pop_front();
+        }
+        queue.clear();
+    }));
+    Report("steady backlog of 1000, std::list", Measure([&] {
+        std::list<int> queue;
+        Steady(queue, 1000, steps);
+    }));
+
+    Report("bursts of 100000, List", Measure([&] {
+        List<int> queue;
+        Bursts(queue, 100000, steps);
+    }));
+    Report("bursts of 100000, std::list", Measure([&] {
+        std::list<int> queue;
+        Bursts(queue, 100000, steps);
+    }));
+}
@@ -0,0 +1,70 @@
+#include "../Vector.cpp"
+#include "bench.h"
+
+#include <cstdlib>
+#include <list>
+#include <string>
+#include <vector>
+
+// Building a Vector from a range in one call, which sizes the storage once,
+// against the push_back loop that doubles its way up.
+
+namespace {
+
+template <typename T, typename Source>
+void Compare(const char *name, const Source &source, int rounds) {
+    Report((std::string(name) + ", append_range").c_str(), Measure([&] {
+        for (int r = 0; r < rounds; ++r) {
+            Vector<T> values;
+            values.append_range(source.begin(), source.end());
+            DoNotOptimize(values[0]);
+        }
+    }));
+    Report((std::string(name) + ", push_back loop").c_str(), Measure([&] {
+        for (int r = 0; r < rounds; ++r) {
+            Vector<T> values;
+            for (const auto &value : source) {
+                values.push_back(value);
+            }
+            DoNotOptimize(values[0]);
+        }
+    }));
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    int scale = argc > 1 ? std::atoi(argv[1]) : 1;
+    size_t n = 1000000 / scale;
+
+    std::vector<int> ints(n);
+    for (size_t i = 0; i < n; ++i) {
+        ints[i] = i;
+    }
+    Compare<int>("int from std::vector", ints, 20);
+    Compare<int>("int from std::list", std::list<int>(ints.begin(), ints.end()), 20);
+
+    std::vector<std::string> strings(n / 10);
+    for (size_t i = 0; i < strings.size(); ++i) {
+        strings[i] = std::to_string(i) + std::string(24, 's');
+    }
+    Compare<std::string>("std::string from std::vector", strings, 5);
+
+    // Inserting a block near the front: one shift of the tail against one
+    // shift per element.
+    std::vector<int> block(1000, 7);
+    Vector<int> base;
+    base.append_range(ints.begin(), ints.begin() + n / 10);
+    Report("insert 1000 ints at the front, range", Measure([&] {
+        Vector<int> values(base);
+        values.insert(values.begin() + 1, block.begin(), block.end());
+        DoNotOptimize(values[1]);
+    }));
+    Report("insert 1000 ints at the front, one by one", Measure([&] {
+        Vector<int> values(base);
+        for (size_t i = 0; i < block.size(); ++i) {
+            values.emplace(values.begin() + 1 + i, block[i]);
+        }
+        DoNotOptimize(values[1]);
+    }));
+}
@@ -0,0 +1,53 @@
+#include "../Vector.cpp"
+#include "bench.h"
+
+#include <cstdlib>
+
+// push_back of 10^7 elements into an empty Vector, where every growth either
+// memcpys the elements over or moves and destroys them one by one.
+
+namespace {
+
+// An owning handle with a real move constructor and destructor. Both
+// instantiations are identical except for the relocation trait.
+template <bool Relocatable>
+struct Handle {
+    int *ptr;
+
+    explicit Handle(int *ptr) : ptr(ptr) {
+    }
+
+    Handle(Handle &&other) noexcept : ptr(other.ptr) {
+        other.ptr = nullptr;
+    }
+
+    ~Handle() {
+        delete ptr;
+    }
+};
+
+}  // namespace
+
+template <>
+struct IsTriviallyRelocatable<Handle<true>> : std::true_type {};
+
+namespace {
+
+template <typename T>
+void PushBack(size_t n) {
+    Vector<T> values;
+    for (size_t i = 0; i < n; ++i) {
+        values.push_back(T(nullptr));
+    }
+    DoNotOptimize(values[n - 1]);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    size_t n = 10000000 / (argc > 1 ? std::atoi(argv[1]) : 1);
+
+    Report("int*", Measure([&] { PushBack<int*>(n); }));
+    Report("handle, trivially relocatable", Measure([&] { PushBack<Handle<true>>(n); }));
+    Report("handle, move and destroy", Measure([&] { PushBack<Handle<false>>(n); }));
+}
@@ -0,0 +1,59 @@
+#include "../List.cpp"
+#include "../UnrolledList.cpp"
+#include "bench.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <list>
+#include <random>
+
+// Summing every element of UnrolledList against List and std::list. Lists
+// built by push_back have their nodes roughly in order in memory; sorting
+// random values scatters them, which is what long-lived lists look like.
+
+namespace {
+
+template <typename Container>
+int64_t Sum(const Container &values) {
+    int64_t total = 0;
+    for (const int &value : values) {
+        total += value;
+    }
+    return total;
+}
+
+template <typename Container>
+void Traverse(const char *name, const Container &values, int rounds) {
+    Report(name, Measure([&] {
+        for (int r = 0; r < rounds; ++r) {
+            DoNotOptimize(Sum(values));
+        }
+    }));
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    size_t n = 1000000 / (argc > 1 ? std::atoi(argv[1]) : 1);
+    int rounds = 20;
+
+    UnrolledList<int> unrolled;
+    List<int> list;
+    List<int> scattered;
+    std::list<int> std_scattered;
+    std::mt19937 gen(1);
+    for (size_t i = 0; i < n; ++i) {
+        int value = gen();
+        unrolled.push_back(value);
+        list.push_back(value);
+        scattered.push_back(value);
+        std_scattered.push_back(value);
+    }
+    scattered.sort();
+    std_scattered.sort();
+
+    Traverse("UnrolledList", unrolled, rounds);
+    Traverse("List, nodes in push order", list, rounds);
+    Traverse("List, nodes scattered by sort", scattered, rounds);
+    Traverse("std::list, nodes scattered by sort", std_scattered, rounds);
+}
@@ -0,0 +1,63 @@
+#include "../vector_algorithms.h"
+#include "bench.h"
+
+#include <cstdlib>
+#include <random>
+#include <string>
+
+// simd::find/count/min/max/sum against the scalar loops they fall back to,
+// over a vector that fits in L2 and is scanned many times.
+
+namespace {
+
+constexpr size_t kSize = 1 << 16;
+
+template <typename T>
+void Run(const char *type, int scans) {
+    std::mt19937 gen(1);
+    Vector<T> values(kSize);
+    for (size_t i = 0; i < kSize; ++i) {
+        values[i] = T(gen() % 1000000);
+    }
+    // Never present, so find scans everything.
+    T missing = T(-1);
+    const T *data = values.begin();
+
+    auto line = [type](const char *what, const char *how, double ms) {
+        Report((std::string(type) + " " + what + " " + how).c_str(), ms);
+    };
+    auto compare = [&](const char *what, auto simd, auto scalar) {
+        line(what, "simd", Measure([&] {
+            for (int i = 0; i < scans; ++i) {
+                DoNotOptimize(simd());
+            }
+        }));
+        line(what, "scalar", Measure([&] {
+            for (int i = 0; i < scans; ++i) {
+                DoNotOptimize(scalar());
+            }
+        }));
+    };
+
+    compare("find", [&] { return simd::find(values, missing); },
+            [&] { return simd::detail::FindScalar(data, kSize, missing); });
+    compare("count", [&] { return simd::count(values, missing); },
+            [&] { return simd::detail::CountScalar(data, kSize, missing); });
+    compare("min", [&] { return simd::min(values); },
+            [&] { return simd::detail::MinScalar(data, kSize); });
+    compare("max", [&] { return simd::max(values); },
+            [&] { return simd::detail::MaxScalar(data, kSize); });
+    compare("sum", [&] { return simd::sum(values); },
+            [&] { return simd::detail::SumScalar(data, kSize); });
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    int scans = 2000 / (argc > 1 ? std::atoi(argv[1]) : 1);
+
+    Run<int32_t>("int32_t", scans);
+    Run<int64_t>("int64_t", scans);
+    Run<float>("float", scans);
+    Run<double>("double", scans);
+}
@@ -0,0 +1,69 @@
+#include "../vector_sort.h"
+#include "bench.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+// std::sort against parallel_sort and radix_sort on random input from 1M to
+// 500M elements. Input, working copy and sort buffer at 500M 16-byte records
+// take about 24 GB; pass a divisor on the command line on smaller machines.
+
+namespace {
+
+struct Record {
+    uint64_t payload;
+    float key;
+};
+
+template <typename T, typename Fill, typename... Sorts>
+void Run(const std::string &name, size_t n, Fill fill, Sorts... sorts) {
+    Vector<T> input(n);
+    std::mt19937_64 gen(n);
+    for (size_t i = 0; i < n; ++i) {
+        input[i] = fill(gen);
+    }
+    Vector<T> values;
+    auto time = [&](const char *how, auto sort) {
+        Report((name + ", " + how).c_str(),
+               MeasureWithSetup([&] { values = input; }, [&] { sort(values); }, 3));
+    };
+    (time(sorts.first, sorts.second), ...);
+}
+
+template <typename Sort>
+std::pair<const char*, Sort> Named(const char *name, Sort sort) {
+    return {name, sort};
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    size_t scale = argc > 1 ? std::atoi(argv[1]) : 1;
+    auto by_key = [](const Record &a, const Record &b) { return a.key < b.key; };
+
+    for (size_t n : {1000000, 10000000, 100000000, 500000000}) {
+        n /= scale;
+        std::string size = std::to_string(n);
+
+        Run<uint32_t>(size + " uint32_t", n, [](auto &gen) { return uint32_t(gen()); },
+            Named("std::sort", [](auto &v) { std::sort(v.begin(), v.end()); }),
+            Named("parallel_sort", [](auto &v) { vector_sort::parallel_sort(v); }),
+            Named("radix_sort", [](auto &v) { vector_sort::radix_sort(v); }));
+
+        Run<double>(size + " double", n,
+            [](auto &gen) { return std::uniform_real_distribution<double>(-1e9, 1e9)(gen); },
+            Named("std::sort", [](auto &v) { std::sort(v.begin(), v.end()); }),
+            Named("parallel_sort", [](auto &v) { vector_sort::parallel_sort(v); }),
+            Named("radix_sort", [](auto &v) { vector_sort::radix_sort(v); }));
+
+        Run<Record>(size + " Record by float key", n,
+            [](auto &gen) { return Record{gen(), float(int32_t(gen()))}; },
+            Named("std::sort", [&](auto &v) { std::sort(v.begin(), v.end(), by_key); }),
+            Named("parallel_sort", [&](auto &v) { vector_sort::parallel_sort(v, by_key); }),
+            Named("radix_sort", [](auto &v) {
+                vector_sort::radix_sort(v, [](const Record &r) { return r.key; });
+            }));
+    }
+}
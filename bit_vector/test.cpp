@@ -0,0 +1,137 @@
+#include "../BitVector.cpp"
+
+#include <catch.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+bool Same(const BitVector &bits, const std::vector<bool> &expected) {
+    if (bits.size() != expected.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (bits[i] != expected[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t CountOnes(const std::vector<bool> &expected) {
+    size_t total = 0;
+    for (bool bit : expected) {
+        total += bit;
+    }
+    return total;
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Against std::vector<bool>") {
+    std::mt19937 gen(29);
+    BitVector bits;
+    std::vector<bool> expected;
+    for (int step = 0; step < 20000; ++step) {
+        switch (gen() % 6) {
+            case 0:
+            case 1: {
+                bool value = gen() % 3 == 0;
+                bits.push_back(value);
+                expected.push_back(value);
+                break;
+            }
+            case 2:
+                if (!expected.empty()) {
+                    bits.pop_back();
+                    expected.pop_back();
+                }
+                break;
+            case 3:
+                if (!expected.empty()) {
+                    size_t index = gen() % expected.size();
+                    bits[index] = !bits[index];
+                    expected[index] = !expected[index];
+                }
+                break;
+            case 4: {
+                size_t size = gen() % 3000;
+                bool value = gen() % 2;
+                bits.resize(size, value);
+                expected.resize(size, value);
+                break;
+            }
+            case 5:
+                bits.flip();
+                expected.flip();
+                break;
+        }
+        if (step % 97 == 0) {
+            REQUIRE(Same(bits, expected));
+            REQUIRE(bits.count() == CountOnes(expected));
+        }
+    }
+
+    size_t index = bits.find_first();
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (expected[i]) {
+            REQUIRE(index == i);
+            index = bits.find_next(index);
+        }
+    }
+    REQUIRE(index == bits.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Bitwise operators") {
+    std::mt19937 gen(31);
+    for (size_t size : {size_t(1), size_t(63), size_t(64), size_t(65), size_t(1000),
+                        size_t(4097)}) {
+        BitVector a(size), b(size);
+        std::vector<bool> ea(size), eb(size);
+        for (size_t i = 0; i < size; ++i) {
+            ea[i] = gen() % 2;
+            eb[i] = gen() % 2;
+            a[i] = ea[i];
+            b[i] = eb[i];
+        }
+        BitVector anded = a, ored = a, xored = a;
+        anded &= b;
+        ored |= b;
+        xored ^= b;
+        std::vector<bool> eand(size), eor(size), exor(size);
+        for (size_t i = 0; i < size; ++i) {
+            eand[i] = ea[i] && eb[i];
+            eor[i] = ea[i] || eb[i];
+            exor[i] = ea[i] != eb[i];
+        }
+        REQUIRE(Same(anded, eand));
+        REQUIRE(Same(ored, eor));
+        REQUIRE(Same(xored, exor));
+        REQUIRE(xored.count() == CountOnes(exor));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Self-assignment") {
+    std::mt19937 gen(37);
+    BitVector bits(1000);
+    std::vector<bool> expected(1000);
+    for (size_t i = 0; i < 1000; ++i) {
+        expected[i] = gen() % 2;
+        bits[i] = expected[i];
+    }
+
+    bits &= bits;
+    REQUIRE(Same(bits, expected));
+    bits |= bits;
+    REQUIRE(Same(bits, expected));
+    bits ^= bits;
+    REQUIRE(bits.count() == 0);
+    REQUIRE(Same(bits, std::vector<bool>(1000)));
+}
@@ -0,0 +1,109 @@
+#include "../CompactList.cpp"
+#include "../Shared_ptr.cpp"
+
+#include <catch.hpp>
+
+#include <list>
+#include <random>
+
+namespace {
+
+template <typename T>
+bool Same(const CompactList<T> &list, const std::list<T> &expected) {
+    if (list.size() != expected.size()) {
+        return false;
+    }
+    auto it = expected.begin();
+    for (const T &value : list) {
+        if (!(value == *it++)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Against std::list") {
+    std::mt19937 gen(13);
+    CompactList<int> list;
+    std::list<int> expected;
+    for (int step = 0; step < 20000; ++step) {
+        int value = static_cast<int>(gen() % 1000);
+        switch (gen() % 7) {
+            case 0:
+            case 1:
+                list.push_back(value);
+                expected.push_back(value);
+                break;
+            case 2:
+                list.push_front(value);
+                expected.push_front(value);
+                break;
+            case 3:
+                if (!expected.empty()) {
+                    list.pop_back();
+                    expected.pop_back();
+                }
+                break;
+            case 4:
+                if (!expected.empty()) {
+                    list.pop_front();
+                    expected.pop_front();
+                }
+                break;
+            case 5:
+            case 6: {
+                size_t index = gen() % (expected.size() + 1);
+                auto it = list.begin();
+                auto jt = expected.begin();
+                for (size_t i = 0; i < index; ++i, ++it, ++jt) {
+                }
+                if (index < expected.size() && gen() % 2 == 0) {
+                    list.erase(it);
+                    expected.erase(jt);
+                } else {
+                    list.insert(it, value);
+                    expected.insert(jt, value);
+                }
+                break;
+            }
+        }
+        if (step % 499 == 0) {
+            REQUIRE(Same(list, expected));
+        }
+    }
+    REQUIRE(Same(list, expected));
+
+    CompactList<int> copy(list);
+    REQUIRE(Same(copy, expected));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Non-trivial elements") {
+    SharedPtr<int> shared(new int(7));
+    {
+        CompactList<SharedPtr<int>> list;
+        for (int i = 0; i < 100; ++i) {
+            list.push_back(shared);
+        }
+        // Full node array: the pushed value is an element of the list itself.
+        for (int i = 0; i < 100; ++i) {
+            list.push_back(list.back());
+        }
+        REQUIRE(list.size() == 200);
+        REQUIRE(shared.UseCount() == 201);
+
+        CompactList<SharedPtr<int>> copy(list);
+        REQUIRE(shared.UseCount() == 401);
+        list.clear();
+        REQUIRE(list.empty());
+        REQUIRE(shared.UseCount() == 201);
+        list.push_front(shared);
+        REQUIRE(*list.front() == 7);
+    }
+    REQUIRE(shared.UseCount() == 1);
+}
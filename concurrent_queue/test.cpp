@@ -0,0 +1,76 @@
+#include "../ConcurrentQueue.cpp"
+
+#include <catch.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Single thread FIFO") {
+    ConcurrentQueue<std::string> queue;
+    REQUIRE(queue.empty());
+    std::string value;
+    REQUIRE(!queue.pop_front(value));
+    for (int i = 0; i < 1000; ++i) {
+        queue.push_back(std::to_string(i));
+    }
+    for (int i = 0; i < 500; ++i) {
+        REQUIRE(queue.pop_front(value));
+        REQUIRE(value == std::to_string(i));
+    }
+    REQUIRE(!queue.empty());
+    // The rest is freed by the destructor.
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Many producers and consumers") {
+    constexpr int kProducers = 4;
+    constexpr int kConsumers = 4;
+    constexpr int kPerProducer = 50000;
+    ConcurrentQueue<int64_t> queue;
+    std::atomic<int> producers_left{kProducers};
+    std::atomic<int64_t> sum{0};
+    std::atomic<int64_t> popped{0};
+    // Per producer, values must come out in the order they went in.
+    std::atomic<bool> ordered{true};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < kProducers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                queue.push_back(int64_t(p) << 32 | i);
+            }
+            producers_left.fetch_sub(1);
+        });
+    }
+    for (int c = 0; c < kConsumers; ++c) {
+        threads.emplace_back([&] {
+            std::vector<int64_t> last(kProducers, -1);
+            int64_t value;
+            while (true) {
+                if (queue.pop_front(value)) {
+                    int producer = int(value >> 32);
+                    int64_t index = value & 0xffffffff;
+                    if (index <= last[producer]) {
+                        ordered = false;
+                    }
+                    last[producer] = index;
+                    sum += index;
+                    ++popped;
+                } else if (producers_left.load() == 0 && queue.empty()) {
+                    break;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    REQUIRE(ordered);
+    REQUIRE(popped == int64_t(kProducers) * kPerProducer);
+    REQUIRE(sum == int64_t(kProducers) * kPerProducer * (kPerProducer - 1) / 2);
+}
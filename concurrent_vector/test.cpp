@@ -0,0 +1,76 @@
+#include "../ConcurrentVector.cpp"
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Throws from its constructor when asked to, and counts live objects.
+struct Fragile {
+    static inline int live = 0;
+    int value;
+
+    explicit Fragile(int value) : value(value) {
+        if (value < 0) {
+            throw std::runtime_error("negative");
+        }
+        ++live;
+    }
+
+    Fragile(Fragile &&other) noexcept : value(other.value) {
+        ++live;
+    }
+
+    ~Fragile() {
+        --live;
+    }
+};
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Concurrent pushes") {
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 20000;
+    ConcurrentVector<std::string> vector;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&vector, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                vector.push_back(std::to_string(t * kPerThread + i));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    REQUIRE(vector.size() == size_t(kThreads * kPerThread));
+    std::vector<int> seen;
+    for (size_t i = 0; i < vector.size(); ++i) {
+        seen.push_back(std::stoi(vector[i]));
+    }
+    std::sort(seen.begin(), seen.end());
+    for (int i = 0; i < kThreads * kPerThread; ++i) {
+        REQUIRE(seen[i] == i);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("A throwing constructor claims no slot") {
+    {
+        ConcurrentVector<Fragile> vector;
+        vector.emplace_back(1);
+        REQUIRE_THROWS(vector.emplace_back(-1));
+        vector.emplace_back(2);
+        REQUIRE(vector.size() == 2);
+        REQUIRE(vector[1].value == 2);
+    }
+    REQUIRE(Fragile::live == 0);
+}
@@ -0,0 +1,75 @@
+#include "../CowVector.cpp"
+
+#include <catch.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Copies share until written") {
+    CowVector<std::string> a(3, "x");
+    CowVector<std::string> b(a);
+    REQUIRE(a.use_count() == 2);
+    REQUIRE(a.begin() == b.begin());
+
+    b.set(1, "y");
+    REQUIRE(a.use_count() == 1);
+    REQUIRE(b.use_count() == 1);
+    REQUIRE(a[1] == "x");
+    REQUIRE(b[1] == "y");
+
+    // A sole owner writes in place.
+    b.push_back("z");
+    b.pop_back();
+    const std::string *data = b.begin();
+    b.set(0, "w");
+    REQUIRE(b.begin() == data);
+    REQUIRE(b.size() == 3);
+    REQUIRE(b[0] == "w");
+
+    CowVector<std::string> c;
+    REQUIRE(c.empty());
+    c = a;
+    c.clear();
+    REQUIRE(c.empty());
+    REQUIRE(a.size() == 3);
+
+    CowVector<std::string> d(std::move(a));
+    REQUIRE(d.size() == 3);
+    d.resize(5);
+    REQUIRE(d[4].empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Snapshots read on other threads") {
+    CowVector<int> shared;
+    for (int i = 0; i < 1000; ++i) {
+        shared.push_back(i);
+    }
+    std::vector<std::thread> readers;
+    std::vector<long long> sums(4);
+    for (int t = 0; t < 4; ++t) {
+        CowVector<int> snapshot(shared);
+        readers.emplace_back([snapshot, &sums, t] {
+            long long sum = 0;
+            for (int value : snapshot) {
+                sum += value;
+            }
+            sums[t] = sum;
+        });
+    }
+    // The writer detaches from every snapshot still held by a reader.
+    for (int i = 0; i < 1000; ++i) {
+        shared.set(i, -1);
+    }
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    for (long long sum : sums) {
+        REQUIRE(sum == 999 * 1000 / 2);
+    }
+    REQUIRE(shared[0] == -1);
+}
@@ -0,0 +1,100 @@
+#include "../Deque.cpp"
+
+#include <catch.hpp>
+
+#include <deque>
+#include <random>
+#include <string>
+
+namespace {
+
+template <typename T>
+bool Same(const Deque<T> &deque, const std::deque<T> &expected) {
+    if (deque.size() != expected.size()) {
+        return false;
+    }
+    size_t i = 0;
+    for (const T &value : deque) {
+        if (!(value == expected[i]) || !(deque[i] == expected[i])) {
+            return false;
+        }
+        ++i;
+    }
+    return i == expected.size();
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Against std::deque") {
+    std::mt19937 gen(5);
+    Deque<std::string> deque;
+    std::deque<std::string> expected;
+    for (int step = 0; step < 200000; ++step) {
+        std::string value = std::to_string(gen() % 1000);
+        // Drifts between growing and shrinking phases so both ends cross
+        // many chunks and the deque empties now and then.
+        bool grow = (step / 5000) % 2 == 0;
+        switch (gen() % 4) {
+            case 0:
+                deque.push_back(value);
+                expected.push_back(value);
+                break;
+            case 1:
+                deque.push_front(value);
+                expected.push_front(value);
+                break;
+            case 2:
+                if (!expected.empty() && !grow) {
+                    deque.pop_back();
+                    expected.pop_back();
+                }
+                break;
+            case 3:
+                if (!expected.empty() && (!grow || gen() % 3 == 0)) {
+                    deque.pop_front();
+                    expected.pop_front();
+                }
+                break;
+        }
+        if (step % 997 == 0) {
+            REQUIRE(Same(deque, expected));
+        }
+    }
+    REQUIRE(Same(deque, expected));
+
+    Deque<std::string> copy(deque);
+    REQUIRE(Same(copy, expected));
+    deque.clear();
+    REQUIRE(deque.empty());
+    deque.push_front("a");
+    deque.push_back("b");
+    REQUIRE(deque.front() == "a");
+    REQUIRE(deque.back() == "b");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Queue use") {
+    Deque<int> queue;
+    for (int i = 0; i < 1000; ++i) {
+        queue.push_back(i);
+    }
+    for (int i = 1000; i < 2000000; ++i) {
+        REQUIRE(queue.front() == i - 1000);
+        queue.pop_front();
+        queue.push_back(i);
+    }
+    REQUIRE(queue.size() == 1000);
+    REQUIRE(queue.back() == 1999999);
+
+    // The other way round, draining it every step.
+    queue.clear();
+    for (int i = 0; i < 2000000; ++i) {
+        queue.push_front(i);
+        REQUIRE(queue.back() == i);
+        queue.pop_back();
+    }
+    REQUIRE(queue.empty());
+}
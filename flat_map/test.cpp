@@ -0,0 +1,101 @@
+#include "../FlatMap.cpp"
+#include "../FlatSet.cpp"
+
+#include <catch.hpp>
+
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("FlatMap against std::map") {
+    std::mt19937 gen(19);
+    FlatMap<int, std::string> map;
+    std::map<int, std::string> expected;
+    for (int step = 0; step < 20000; ++step) {
+        int key = static_cast<int>(gen() % 500) - 250;
+        std::string value = std::to_string(gen() % 100);
+        switch (gen() % 5) {
+            case 0:
+                REQUIRE(map.insert(key, value) == expected.emplace(key, value).second);
+                break;
+            case 1:
+                map.insert_or_assign(key, value);
+                expected[key] = value;
+                break;
+            case 2:
+                map[key] += "x";
+                expected[key] += "x";
+                break;
+            case 3:
+                REQUIRE(map.erase(key) == expected.erase(key));
+                break;
+            case 4: {
+                const std::string *found = map.find(key);
+                auto it = expected.find(key);
+                REQUIRE((found == nullptr) == (it == expected.end()));
+                if (found != nullptr) {
+                    REQUIRE(*found == it->second);
+                }
+                break;
+            }
+        }
+    }
+    REQUIRE(map.size() == expected.size());
+    size_t i = 0;
+    for (const auto &[key, value] : expected) {
+        REQUIRE(map.key(i) == key);
+        REQUIRE(map.value(i) == value);
+        ++i;
+    }
+}
+
+TEST_CASE("FlatMap bulk construction keeps the first of equal keys") {
+    Vector<std::pair<int, int>> entries;
+    entries.push_back({3, 30});
+    entries.push_back({1, 10});
+    entries.push_back({3, 31});
+    entries.push_back({2, 20});
+    FlatMap<int, int> map(entries);
+    REQUIRE(map.size() == 3);
+    REQUIRE(*map.find(3) == 30);
+    REQUIRE(map.contains(1));
+    REQUIRE(!map.contains(4));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("FlatSet against std::set") {
+    std::mt19937 gen(23);
+    Vector<int> initial;
+    for (int i = 0; i < 1000; ++i) {
+        initial.push_back(static_cast<int>(gen() % 700));
+    }
+    FlatSet<int, std::greater<int>> set(initial);
+    std::set<int, std::greater<int>> expected(initial.begin(), initial.end());
+    for (int step = 0; step < 20000; ++step) {
+        int key = static_cast<int>(gen() % 1000);
+        switch (gen() % 3) {
+            case 0:
+                REQUIRE(set.insert(key) == expected.insert(key).second);
+                break;
+            case 1:
+                REQUIRE(set.erase(key) == expected.erase(key));
+                break;
+            case 2: {
+                REQUIRE(set.contains(key) == (expected.count(key) == 1));
+                const int *bound = set.lower_bound(key);
+                auto it = expected.lower_bound(key);
+                REQUIRE((bound == set.end()) == (it == expected.end()));
+                if (bound != set.end()) {
+                    REQUIRE(*bound == *it);
+                }
+                break;
+            }
+        }
+    }
+    REQUIRE(set.size() == expected.size());
+    REQUIRE(std::equal(set.begin(), set.end(), expected.begin(), expected.end()));
+}
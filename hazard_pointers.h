@@ -0,0 +1,155 @@
+#pragma once
+
+#include "Vector.cpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+// Hazard pointers for lock-free structures that unlink nodes other threads
+// may still be reading. Before dereferencing a shared node a thread publishes
+// it with Protect; unlinked nodes are handed to Retire and freed only once no
+// thread has them published.
+//
+// Each thread takes a record on first use and gives it back when it exits;
+// records themselves live until the program ends, and a later thread picks
+// up a released record together with anything it still had retired.
+class HazardPointers {
+public:
+    static constexpr size_t kSlots = 2;
+
+    // Loads src and publishes the result in slot until it is stable, so the
+    // returned node cannot be freed before the slot is cleared.
+    template <typename T>
+    static T* Protect(size_t slot, const std::atomic<T*> &src) {
+        std::atomic<void*> &hazard = Local().record->hazards[slot];
+        T *ptr = src.load(std::memory_order_relaxed);
+        while (true) {
+            hazard.store(ptr, std::memory_order_seq_cst);
+            T *again = src.load(std::memory_order_seq_cst);
+            if (again == ptr) {
+                return ptr;
+            }
+            ptr = again;
+        }
+    }
+
+    static void Clear(size_t slot) {
+        Local().record->hazards[slot].store(nullptr, std::memory_order_release);
+    }
+
+    // ptr must already be unreachable for threads that have not protected it.
+    static void Retire(void *ptr, void (*deleter)(void*)) {
+        Record *record = Local().record;
+        record->retired.push_back({ptr, deleter});
+        // Scanning once the list outgrows every published slot twice over
+        // frees at least half of it, keeping the cost per node constant.
+        size_t published = kSlots * Records().count.load(std::memory_order_relaxed);
+        if (record->retired.size() >= kScanThreshold + 2 * published) {
+            Scan(record);
+        }
+    }
+
+private:
+    static constexpr size_t kScanThreshold = 64;
+
+    struct Retired {
+        void *ptr;
+        void (*deleter)(void*);
+    };
+
+    struct Record {
+        std::atomic<void*> hazards[kSlots] = {};
+        std::atomic<bool> active{true};
+        Record *next = nullptr;
+        Vector<Retired> retired;
+    };
+
+    // Every record ever created. Freed, with whatever is still retired, when
+    // the program ends and no other thread can be running.
+    struct RecordList {
+        std::atomic<Record*> head{nullptr};
+        std::atomic<size_t> count{0};
+
+        ~RecordList() {
+            Record *record = head.load(std::memory_order_acquire);
+            while (record != nullptr) {
+                Record *next = record->next;
+                for (size_t i = 0; i < record->retired.size(); ++i) {
+                    record->retired[i].deleter(record->retired[i].ptr);
+                }
+                delete record;
+                record = next;
+            }
+        }
+    };
+
+    // The calling thread's record, released when the thread exits.
+    struct LocalRecord {
+        Record *record;
+
+        LocalRecord() : record(Acquire()) {
+        }
+
+        ~LocalRecord() {
+            for (auto &hazard : record->hazards) {
+                hazard.store(nullptr, std::memory_order_release);
+            }
+            record->active.store(false, std::memory_order_release);
+        }
+    };
+
+    static RecordList& Records() {
+        static RecordList records;
+        return records;
+    }
+
+    static LocalRecord& Local() {
+        thread_local LocalRecord local;
+        return local;
+    }
+
+    static Record* Acquire() {
+        RecordList &records = Records();
+        for (Record *record = records.head.load(std::memory_order_acquire); record != nullptr;
+             record = record->next) {
+            bool active = false;
+            if (!record->active.load(std::memory_order_relaxed) &&
+                record->active.compare_exchange_strong(active, true, std::memory_order_acquire)) {
+                return record;
+            }
+        }
+        Record *record = new Record();
+        record->next = records.head.load(std::memory_order_relaxed);
+        while (!records.head.compare_exchange_weak(record->next, record, std::memory_order_release,
+                                                   std::memory_order_relaxed)) {
+        }
+        records.count.fetch_add(1, std::memory_order_relaxed);
+        return record;
+    }
+
+    // Frees the retired nodes of record that no thread has published.
+    static void Scan(Record *record) {
+        Vector<void*> published;
+        for (Record *other = Records().head.load(std::memory_order_acquire); other != nullptr;
+             other = other->next) {
+            for (auto &hazard : other->hazards) {
+                void *ptr = hazard.load(std::memory_order_seq_cst);
+                if (ptr != nullptr) {
+                    published.push_back(ptr);
+                }
+            }
+        }
+        std::sort(published.begin(), published.end());
+
+        Vector<Retired> kept;
+        for (size_t i = 0; i < record->retired.size(); ++i) {
+            Retired retired = record->retired[i];
+            if (std::binary_search(published.begin(), published.end(), retired.ptr)) {
+                kept.push_back(retired);
+            } else {
+                retired.deleter(retired.ptr);
+            }
+        }
+        record->retired.swap(kept);
+    }
+};
@@ -0,0 +1,288 @@
+#include "../List.cpp"
+
+#include <catch.hpp>
+
+#include <list>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+template <typename T>
+bool Same(const List<T> &list, const std::list<T> &expected) {
+    if (list.size() != expected.size()) {
+        return false;
+    }
+    auto it = expected.begin();
+    for (const T &value : list) {
+        if (!(value == *it++)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Against std::list") {
+    std::mt19937 gen(3);
+    List<std::string> list;
+    std::list<std::string> expected;
+    for (int step = 0; step < 20000; ++step) {
+        std::string value = std::to_string(gen() % 1000);
+        switch (gen() % 6) {
+            case 0:
+            case 1:
+                list.push_back(value);
+                expected.push_back(value);
+                break;
+            case 2:
+                list.push_front(value);
+                expected.push_front(value);
+                break;
+            case 3:
+                if (!expected.empty()) {
+                    list.pop_back();
+                    expected.pop_back();
+                }
+                break;
+            case 4:
+                if (!expected.empty()) {
+                    list.pop_front();
+                    expected.pop_front();
+                }
+                break;
+            case 5: {
+                size_t index = gen() % (expected.size() + 1);
+                auto it = list.begin();
+                auto jt = expected.begin();
+                for (size_t i = 0; i < index; ++i, ++it, ++jt) {
+                }
+                list.insert(it, value);
+                expected.insert(jt, value);
+                break;
+            }
+        }
+    }
+    REQUIRE(Same(list, expected));
+
+    list.sort();
+    expected.sort();
+    REQUIRE(Same(list, expected));
+
+    size_t before = expected.size();
+    expected.unique();
+    REQUIRE(list.unique() == before - expected.size());
+    REQUIRE(Same(list, expected));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Splice and merge") {
+    SECTION("Whole lists") {
+        List<int> a, b;
+        for (int i = 0; i < 100; ++i) {
+            a.push_back(2 * i);
+            b.push_back(2 * i + 1);
+        }
+        a.merge(b);
+        REQUIRE(b.empty());
+        REQUIRE(a.size() == 200);
+        int expected = 0;
+        for (int value : a) {
+            REQUIRE(value == expected++);
+        }
+
+        List<int> c;
+        c.splice(c.end(), a);
+        REQUIRE(a.empty());
+        REQUIRE(c.size() == 200);
+        // Nodes that came from b are freed through the shared pool.
+        c.clear();
+        a.push_back(1);
+        REQUIRE(a.front() == 1);
+    }
+
+    SECTION("Ranges") {
+        List<int> a, b;
+        std::list<int> ea, eb;
+        for (int i = 0; i < 10; ++i) {
+            a.push_back(i);
+            ea.push_back(i);
+            b.push_back(100 + i);
+            eb.push_back(100 + i);
+        }
+        auto first = b.begin();
+        ++first;
+        auto last = first;
+        ++last;
+        ++last;
+        ++last;
+        a.splice(a.begin(), b, first, last);
+        auto efirst = std::next(eb.begin());
+        ea.splice(ea.begin(), eb, efirst, std::next(efirst, 3));
+        REQUIRE(Same(a, ea));
+        REQUIRE(Same(b, eb));
+
+        a.splice(a.end(), a, a.begin());
+        ea.splice(ea.end(), ea, ea.begin());
+        REQUIRE(Same(a, ea));
+
+        List<int> empty;
+        empty.splice(empty.end(), a, a.begin());
+        ea.pop_front();
+        REQUIRE(Same(a, ea));
+        REQUIRE(empty.size() == 1);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Batches spliced across threads") {
+    constexpr int kBatches = 2000;
+    constexpr int kBatchSize = 16;
+    List<int> queue;
+    std::mutex mutex;
+    long long sum = 0;
+
+    std::thread consumer([&] {
+        int received = 0;
+        while (received < kBatches * kBatchSize) {
+            List<int> taken;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                taken.splice(taken.end(), queue);
+            }
+            received += static_cast<int>(taken.size());
+            while (!taken.empty()) {
+                sum += taken.front();
+                taken.pop_front();
+            }
+        }
+    });
+
+    // The producer keeps allocating from its pool while the consumer frees
+    // the same nodes back into it.
+    List<int> batch;
+    for (int i = 0; i < kBatches; ++i) {
+        for (int j = 0; j < kBatchSize; ++j) {
+            batch.push_back(1);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.splice(queue.end(), batch);
+    }
+    consumer.join();
+    REQUIRE(sum == kBatches * kBatchSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Pools outliving their lists") {
+    SECTION("Nodes freed elsewhere after the owner died") {
+        List<std::string> kept;
+        for (int i = 0; i < 100; ++i) {
+            List<std::string> batch;
+            for (int j = 0; j < 10; ++j) {
+                batch.push_back(std::string(30, char('a' + j)));
+            }
+            auto middle = batch.begin();
+            for (int j = 0; j < 5; ++j) {
+                ++middle;
+            }
+            kept.splice(kept.end(), batch, batch.begin(), middle);
+        }
+        REQUIRE(kept.size() == 500);
+        for (int i = 0; i < 250; ++i) {
+            kept.pop_front();
+        }
+        REQUIRE(kept.front() == std::string(30, 'a'));
+    }
+
+    SECTION("Nodes coming home") {
+        List<int> owner;
+        List<int> other;
+        for (int i = 0; i < 100; ++i) {
+            owner.push_back(i);
+        }
+        other.splice(other.end(), owner);
+        other.push_back(100);
+        owner.splice(owner.end(), other);
+        int expected = 0;
+        for (int value : owner) {
+            REQUIRE(value == expected++);
+        }
+        REQUIRE(expected == 101);
+        owner.clear();
+        for (int i = 0; i < 1000; ++i) {
+            owner.push_back(i);
+        }
+        REQUIRE(owner.size() == 1000);
+    }
+
+    SECTION("Across threads") {
+        List<int> queue;
+        std::mutex mutex;
+        long long sum = 0;
+        std::thread consumer([&] {
+            int received = 0;
+            while (received < 1000 * 8) {
+                List<int> taken;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    taken.splice(taken.end(), queue);
+                }
+                received += static_cast<int>(taken.size());
+                while (!taken.empty()) {
+                    sum += taken.front();
+                    taken.pop_front();
+                }
+            }
+        });
+        // Each batch list dies right after handing its nodes over, so the
+        // consumer frees the last nodes of pools whose owner is gone.
+        for (int i = 0; i < 1000; ++i) {
+            List<int> batch;
+            for (int j = 0; j < 8; ++j) {
+                batch.push_back(1);
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.splice(queue.end(), batch);
+        }
+        consumer.join();
+        REQUIRE(sum == 1000 * 8);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Copies keep the allocator") {
+    SECTION("Arena") {
+        MonotonicArena arena;
+        List<std::string, ArenaAllocator<std::string>> list(ArenaAllocator<std::string>{arena});
+        list.push_back("a");
+        list.push_back("b");
+        List<std::string, ArenaAllocator<std::string>> copy(list);
+        REQUIRE(copy.size() == 2);
+        REQUIRE(copy.back() == "b");
+        copy = list;
+        REQUIRE(copy.front() == "a");
+    }
+
+    SECTION("Pool") {
+        SizeClassPool pool;
+        List<int, PoolAllocator<int>> list(PoolAllocator<int>{pool});
+        for (int i = 0; i < 100; ++i) {
+            list.push_back(i);
+        }
+        List<int, PoolAllocator<int>> copy(list);
+        REQUIRE(copy.size() == 100);
+        copy.splice(copy.end(), list);
+        REQUIRE(copy.size() == 200);
+        REQUIRE(list.empty());
+    }
+}
@@ -0,0 +1,70 @@
+#include "../MappedVector.cpp"
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+struct TempFile {
+    std::string path;
+
+    TempFile() {
+        char name[] = "/tmp/mapped_vector_testXXXXXX";
+        int fd = mkstemp(name);
+        close(fd);
+        std::remove(name);
+        path = name;
+    }
+
+    ~TempFile() {
+        std::remove(path.c_str());
+    }
+};
+
+struct Point {
+    double x, y;
+};
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Reopening") {
+    TempFile file;
+    {
+        MappedVector<Point> points(file.path.c_str(), 7);
+        for (int i = 0; i < 10000; ++i) {
+            points.push_back({double(i), -double(i)});
+        }
+    }
+    MappedVector<Point> points(file.path.c_str(), 7);
+    REQUIRE(points.size() == 10000);
+    REQUIRE(points[9999].x == 9999);
+    REQUIRE(points[9999].y == -9999);
+
+    REQUIRE_THROWS(MappedVector<Point>(file.path.c_str(), 8));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Pushing an element of the vector") {
+    TempFile file, other_file;
+    MappedVector<Point> points(file.path.c_str());
+    // Growing a second mapping alongside leaves no room to remap in place.
+    MappedVector<Point> other(other_file.path.c_str());
+    points.push_back({1, 2});
+    for (int i = 0; i < 100000; ++i) {
+        // Lands on a full vector every time the capacity doubles.
+        points.push_back(points[points.size() - 1]);
+        other.push_back({0, 0});
+        other.push_back({0, 0});
+    }
+    REQUIRE(points.size() == 100001);
+    bool same = true;
+    for (size_t i = 0; i < points.size(); ++i) {
+        same = same && points[i].x == 1 && points[i].y == 2;
+    }
+    REQUIRE(same);
+}
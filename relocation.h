@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+// A type is trivially relocatable if moving an object to a new address and
+// ending the lifetime of the old one is equivalent to a memcpy of its bytes.
+// Trivially copyable types qualify automatically; other types opt in with
+//
+//     template <>
+//     struct IsTriviallyRelocatable<MyType> : std::true_type {};
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+// References are stored as pointers, so wrappers holding them relocate fine.
+template <typename T>
+struct IsTriviallyRelocatable<T&> : std::true_type {};
+
+template <typename T>
+inline constexpr bool IsTriviallyRelocatableV = IsTriviallyRelocatable<T>::value;
+
+// Moves count objects from `from` into uninitialized storage at `to` and ends
+// the lifetime of the originals.
+template <typename T>
+void UninitializedRelocateN(T* from, size_t count, T* to) {
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        if (count != 0) {
+            std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(T));
+        }
+    } else {
+        std::uninitialized_move_n(from, count, to);
+        std::destroy_n(from, count);
+    }
+}
@@ -0,0 +1,130 @@
+#define VECTOR_STATS
+#include "../SmallVector.cpp"
+
+#include <catch.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <typename T, size_t N>
+bool Same(const SmallVector<T, N> &vector, const std::vector<T> &expected) {
+    return vector.size() == expected.size() &&
+           std::equal(vector.begin(), vector.end(), expected.begin(), expected.end());
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Inline and heap storage") {
+    SmallVector<std::string, 4> vector;
+    for (int i = 0; i < 4; ++i) {
+        vector.push_back(std::to_string(i));
+    }
+    REQUIRE(vector.capacity() == 4);
+    REQUIRE(vector.begin() != nullptr);
+    vector.push_back("4");
+    REQUIRE(vector.capacity() >= 5);
+    REQUIRE(vector[4] == "4");
+    REQUIRE(vector[0] == "0");
+
+    SmallVector<std::string, 4> copy(vector);
+    REQUIRE(copy.size() == 5);
+    SmallVector<std::string, 4> moved(std::move(copy));
+    REQUIRE(moved[3] == "3");
+    REQUIRE(copy.size() == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Pushing an element of the vector") {
+    SECTION("Copy") {
+        SmallVector<std::string, 2> vector;
+        vector.push_back(std::string(32, 'a'));
+        vector.push_back(std::string(32, 'b'));
+        // Full inline, then full on the heap.
+        vector.push_back(vector[0]);
+        vector.push_back(vector[1]);
+        vector.push_back(vector[2]);
+        REQUIRE(vector.size() == 5);
+        REQUIRE(vector[2] == std::string(32, 'a'));
+        REQUIRE(vector[3] == std::string(32, 'b'));
+        REQUIRE(vector[4] == std::string(32, 'a'));
+    }
+
+    SECTION("Move") {
+        SmallVector<std::string, 1> vector;
+        vector.push_back(std::string(32, 'a'));
+        vector.push_back(std::move(vector[0]));
+        REQUIRE(vector[1] == std::string(32, 'a'));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Against std::vector") {
+    std::mt19937 gen(9);
+    SmallVector<int, 8> vector;
+    std::vector<int> expected;
+    for (int step = 0; step < 10000; ++step) {
+        switch (gen() % 5) {
+            case 0:
+            case 1: {
+                int value = static_cast<int>(gen());
+                vector.push_back(value);
+                expected.push_back(value);
+                break;
+            }
+            case 2:
+                if (!expected.empty()) {
+                    vector.pop_back();
+                    expected.pop_back();
+                }
+                break;
+            case 3: {
+                size_t size = gen() % 20;
+                vector.resize(size);
+                expected.resize(size);
+                break;
+            }
+            case 4: {
+                SmallVector<int, 8> other;
+                other.swap(vector);
+                vector.swap(other);
+                break;
+            }
+        }
+        REQUIRE(Same(vector, expected));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Stats count only heap elements") {
+    VectorTypeStats &longs = VectorStats::Get<long>();
+    int64_t live = longs.live_bytes;
+    int64_t used = longs.used_bytes;
+    {
+        SmallVector<long, 4> vector;
+        for (int i = 0; i < 4; ++i) {
+            vector.push_back(i);
+        }
+        REQUIRE(longs.used_bytes == used);
+        vector.push_back(4);
+        REQUIRE(longs.used_bytes - used == 5 * int64_t(sizeof(long)));
+        for (int i = 5; i < 8; ++i) {
+            vector.push_back(i);
+        }
+        REQUIRE(longs.live_bytes - live == longs.used_bytes - used);
+
+        SmallVector<long, 4> moved(std::move(vector));
+        REQUIRE(longs.used_bytes - used == 8 * int64_t(sizeof(long)));
+        moved.pop_back();
+        REQUIRE(longs.used_bytes - used == 7 * int64_t(sizeof(long)));
+    }
+    REQUIRE(longs.live_bytes == live);
+    REQUIRE(longs.used_bytes == used);
+}
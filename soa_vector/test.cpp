@@ -0,0 +1,65 @@
+#define VECTOR_STATS
+#include "../SoAVector.cpp"
+
+#include <catch.hpp>
+
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Columns") {
+    SoAVector<int, std::string> vector;
+    for (int i = 0; i < 1000; ++i) {
+        vector.push_back(i, std::to_string(i));
+    }
+    REQUIRE(vector.size() == 1000);
+    auto [number, name] = vector[500];
+    REQUIRE(number == 500);
+    REQUIRE(name == "500");
+    name = "changed";
+    REQUIRE(std::get<1>(vector[500]) == "changed");
+
+    SoAVector<int, std::string> copy(vector);
+    vector.pop_back();
+    vector.resize(10);
+    REQUIRE(vector.size() == 10);
+    REQUIRE(copy.size() == 1000);
+    REQUIRE(std::get<1>(copy[999]) == "999");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Pushing fields of the vector") {
+    SoAVector<std::string, int> vector;
+    vector.push_back(std::string(32, 'a'), 1);
+    for (int i = 0; i < 20; ++i) {
+        auto [text, number] = vector[0];
+        vector.push_back(text, number);
+    }
+    REQUIRE(vector.size() == 21);
+    for (size_t i = 0; i < vector.size(); ++i) {
+        REQUIRE(std::get<0>(vector[i]) == std::string(32, 'a'));
+        REQUIRE(std::get<1>(vector[i]) == 1);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Stats count used bytes per column") {
+    VectorTypeStats &shorts = VectorStats::Get<short>();
+    int64_t live = shorts.live_bytes;
+    int64_t used = shorts.used_bytes;
+    {
+        SoAVector<short, double> vector;
+        for (int i = 0; i < 64; ++i) {
+            vector.push_back(short(i), i);
+        }
+        REQUIRE(shorts.live_bytes - live == 64 * int64_t(sizeof(short)));
+        REQUIRE(shorts.used_bytes - used == 64 * int64_t(sizeof(short)));
+        vector.pop_back();
+        vector.resize(10);
+        REQUIRE(shorts.used_bytes - used == 10 * int64_t(sizeof(short)));
+    }
+    REQUIRE(shorts.live_bytes == live);
+    REQUIRE(shorts.used_bytes == used);
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency()) {
+        if (threads == 0) {
+            threads = 1;
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] { Work(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    // Shared pool sized to the machine, created on first use.
+    static ThreadPool& Global() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    size_t Size() const {
+        return workers_.size();
+    }
+
+    // Splits [0, count) into contiguous ranges of at least min_chunk elements
+    // and calls body(begin, end) for each, one range per thread. The calling
+    // thread takes part and keeps running queued tasks until its ranges are
+    // done, so nested calls cannot deadlock. body must not throw.
+    template <typename Body>
+    void ParallelFor(size_t count, size_t min_chunk, Body body) {
+        size_t chunks = count / (min_chunk ? min_chunk : 1);
+        if (chunks > Size() + 1) {
+            chunks = Size() + 1;
+        }
+        if (chunks <= 1) {
+            body(size_t(0), count);
+            return;
+        }
+
+        std::atomic<size_t> pending(chunks - 1);
+        size_t step = count / chunks;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 1; i < chunks; ++i) {
+                size_t begin = i * step;
+                size_t end = i + 1 == chunks ? count : begin + step;
+                tasks_.emplace_back([&body, &pending, begin, end] {
+                    body(begin, end);
+                    pending.fetch_sub(1, std::memory_order_release);
+                });
+            }
+        }
+        wake_.notify_all();
+
+        body(size_t(0), step);
+        while (pending.load(std::memory_order_acquire) != 0) {
+            if (!RunOne()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    bool RunOne() {
+        std::function<void()> task;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (tasks_.empty()) {
+                return false;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+        return true;
+    }
+
+    void Work() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+};
@@ -0,0 +1,146 @@
+#include "../UnrolledList.cpp"
+
+#include <catch.hpp>
+
+#include <list>
+#include <random>
+#include <string>
+
+namespace {
+
+template <typename T>
+bool Same(const UnrolledList<T> &list, const std::list<T> &expected) {
+    if (list.size() != expected.size()) {
+        return false;
+    }
+    auto it = expected.begin();
+    for (const T &value : list) {
+        if (!(value == *it++)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Against std::list") {
+    std::mt19937 gen(37);
+    UnrolledList<int> list;
+    std::list<int> expected;
+    for (int step = 0; step < 20000; ++step) {
+        int value = static_cast<int>(gen() % 1000);
+        switch (gen() % 7) {
+            case 0:
+            case 1:
+                list.push_back(value);
+                expected.push_back(value);
+                break;
+            case 2:
+                list.push_front(value);
+                expected.push_front(value);
+                break;
+            case 3:
+                if (!expected.empty()) {
+                    list.pop_back();
+                    expected.pop_back();
+                }
+                break;
+            case 4:
+                if (!expected.empty()) {
+                    list.pop_front();
+                    expected.pop_front();
+                }
+                break;
+            case 5:
+            case 6: {
+                size_t index = gen() % (expected.size() + 1);
+                auto it = list.begin();
+                auto jt = expected.begin();
+                for (size_t i = 0; i < index; ++i, ++it, ++jt) {
+                }
+                if (index < expected.size() && gen() % 2 == 0) {
+                    list.erase(it);
+                    expected.erase(jt);
+                } else {
+                    list.insert(it, value);
+                    expected.insert(jt, value);
+                }
+                break;
+            }
+        }
+        if (step % 499 == 0) {
+            REQUIRE(Same(list, expected));
+        }
+    }
+    REQUIRE(Same(list, expected));
+
+    UnrolledList<int> copy(list);
+    REQUIRE(Same(copy, expected));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Non-trivial elements") {
+    std::mt19937 gen(41);
+    UnrolledList<std::string> list;
+    std::list<std::string> expected;
+    // Inserting in the middle splits full nodes, erasing merges them again.
+    for (int step = 0; step < 20000; ++step) {
+        size_t index = gen() % (expected.size() + 1);
+        auto it = list.begin();
+        auto jt = expected.begin();
+        for (size_t i = 0; i < index; ++i, ++it, ++jt) {
+        }
+        if (index < expected.size() && (step / 4000) % 2 == 1) {
+            it = list.erase(it);
+            jt = expected.erase(jt);
+            REQUIRE((jt == expected.end()) == (it == list.end()));
+        } else {
+            std::string value(24, char('a' + step % 26));
+            REQUIRE(*list.insert(it, value) == value);
+            expected.insert(jt, value);
+        }
+    }
+    REQUIRE(Same(list, expected));
+
+    UnrolledList<std::string> copy;
+    copy = list;
+    list.clear();
+    REQUIRE(list.empty());
+    REQUIRE(Same(copy, expected));
+    copy.swap(list);
+    REQUIRE(copy.empty());
+    REQUIRE(Same(list, expected));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Pushing an element of the list") {
+    constexpr size_t kCapacity = UnrolledList<std::string>::kNodeCapacity;
+    UnrolledList<std::string> list;
+    for (size_t i = 0; i < kCapacity; ++i) {
+        list.push_back(std::string(40, char('a' + i % 26)));
+    }
+
+    SECTION("Back") {
+        // The tail node is full at its end but has room in front, so the
+        // push shifts the elements down first.
+        list.pop_front();
+        std::string last = list.back();
+        list.push_back(list.back());
+        REQUIRE(list.back() == last);
+        REQUIRE(list.size() == kCapacity);
+    }
+
+    SECTION("Front") {
+        list.pop_back();
+        std::string first = list.front();
+        list.push_front(list.front());
+        REQUIRE(list.front() == first);
+        REQUIRE(*++list.begin() == first);
+        REQUIRE(list.size() == kCapacity);
+    }
+}
@@ -0,0 +1,452 @@
+#define VECTOR_STATS
+#include "../Vector.cpp"
+#include "../Shared_ptr.cpp"
+#include "../allocators.h"
+
+#include <catch.hpp>
+
+#include <iterator>
+#include <list>
+#include <random>
+#include <sstream>
+#include <typeinfo>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Bulk construction") {
+    SECTION("Trivial elements") {
+        Vector<int> values(3000000, 7);
+        REQUIRE(values.size() == 3000000);
+        REQUIRE(values[0] == 7);
+        REQUIRE(values[2999999] == 7);
+
+        Vector<int> copy(values);
+        REQUIRE(copy[1500000] == 7);
+    }
+
+    SECTION("Shared reference counts") {
+        SharedPtr<int> p(new int(5));
+        {
+            Vector<SharedPtr<int>> values(2000000, p);
+            REQUIRE(p.UseCount() == 2000001);
+            Vector<SharedPtr<int>> copy(values);
+            REQUIRE(p.UseCount() == 4000001);
+        }
+        REQUIRE(p.UseCount() == 1);
+    }
+
+    SECTION("Strings") {
+        Vector<std::string> values(1000000, std::string(40, 'a'));
+        Vector<std::string> copy(values);
+        REQUIRE(copy[999999] == std::string(40, 'a'));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Copy assignment keeps the allocator") {
+    MonotonicArena long_lived;
+    Vector<int, ArenaAllocator<int>> kept(ArenaAllocator<int>{long_lived});
+    kept.push_back(1);
+    {
+        MonotonicArena request;
+        Vector<int, ArenaAllocator<int>> scoped(ArenaAllocator<int>{request});
+        for (int i = 0; i < 1000; ++i) {
+            scoped.push_back(i);
+        }
+        kept = scoped;
+        REQUIRE(kept.get_allocator() == ArenaAllocator<int>(long_lived));
+    }
+    // The request arena is gone; kept must not have been using it.
+    REQUIRE(kept.size() == 1000);
+    REQUIRE(kept[999] == 999);
+    kept.push_back(1000);
+    REQUIRE(kept[1000] == 1000);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Growth through realloc and mremap") {
+    Vector<int64_t, ReallocAllocator<int64_t>> values;
+    // Crosses the mapping threshold on the way up.
+    for (int64_t i = 0; i < 1000000; ++i) {
+        values.push_back(i);
+    }
+    bool intact = true;
+    for (int64_t i = 0; i < 1000000; ++i) {
+        intact = intact && values[i] == i;
+    }
+    REQUIRE(intact);
+
+    values.resize(10);
+    values.shrink_to_fit();
+    REQUIRE(values.capacity() == 10);
+    REQUIRE(values[9] == 9);
+    values.resize(300000, 7);
+    REQUIRE(values[299999] == 7);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Huge page storage") {
+    SECTION("Every block mapped") {
+        // A page mapped right behind each new block keeps mremap from
+        // growing it in place, so every growth moves the mapping.
+        Vector<int, HugePageAllocator<int, 0>> values;
+        std::vector<void*> guards;
+        for (int i = 0; i < 3000000; ++i) {
+            size_t capacity = values.capacity();
+            values.push_back(i);
+            if (values.capacity() != capacity) {
+                REQUIRE(reinterpret_cast<uintptr_t>(values.begin()) % PageMemory::kHugePageSize == 0);
+                char *end = reinterpret_cast<char*>(values.begin()) +
+                            PageMemory::RoundUpHuge(values.capacity() * sizeof(int));
+                void *guard = mmap(end, PageMemory::PageSize(), PROT_NONE,
+                                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+                if (guard != MAP_FAILED) {
+                    guards.push_back(guard);
+                }
+            }
+        }
+        REQUIRE(values[2999999] == 2999999);
+        for (void *guard : guards) {
+            munmap(guard, PageMemory::PageSize());
+        }
+        values.resize(100000);
+        values.shrink_to_fit();
+        REQUIRE(reinterpret_cast<uintptr_t>(values.begin()) % PageMemory::kHugePageSize == 0);
+        Vector<int, HugePageAllocator<int, 0>> copy(values);
+        REQUIRE(copy[99999] == 99999);
+        REQUIRE(reinterpret_cast<uintptr_t>(copy.begin()) % PageMemory::kHugePageSize == 0);
+        copy.clear();
+        copy.shrink_to_fit();
+        REQUIRE(copy.capacity() == 0);
+    }
+
+    SECTION("Small blocks on the heap, large ones mapped") {
+        Vector<std::string, HugePageAllocator<std::string>> values;
+        for (int i = 0; i < 200000; ++i) {
+            values.push_back(std::to_string(i));
+        }
+        REQUIRE(values[199999] == "199999");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Uninitialized growth") {
+    Vector<int> values(3, 1);
+    values.resize_for_overwrite(1000);
+    REQUIRE(values.size() == 1000);
+    REQUIRE(values[2] == 1);
+    for (int i = 3; i < 1000; ++i) {
+        values[i] = i;
+    }
+
+    int *appended = values.append_uninitialized(5000);
+    REQUIRE(appended == values.begin() + 1000);
+    REQUIRE(values.size() == 6000);
+    for (int i = 0; i < 5000; ++i) {
+        appended[i] = -i;
+    }
+    REQUIRE(values[999] == 999);
+    REQUIRE(values[5999] == -4999);
+
+    values.resize_for_overwrite(10);
+    REQUIRE(values.size() == 10);
+    REQUIRE(values[9] == 9);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+template <typename T>
+bool Same(const Vector<T> &values, const std::vector<T> &expected) {
+    return values.size() == expected.size() &&
+           std::equal(values.begin(), values.end(), expected.begin());
+}
+
+}  // namespace
+
+TEST_CASE("Range insert") {
+    SECTION("Against std::vector") {
+        std::mt19937 gen(7);
+        Vector<std::string> values;
+        std::vector<std::string> expected;
+        for (int step = 0; step < 500; ++step) {
+            std::vector<std::string> source(gen() % 20);
+            for (auto &value : source) {
+                value = std::to_string(gen()) + std::string(gen() % 30, 'x');
+            }
+            size_t index = gen() % (expected.size() + 1);
+            switch (gen() % 4) {
+            case 0:
+                values.insert(values.begin() + index, source.begin(), source.end());
+                expected.insert(expected.begin() + index, source.begin(), source.end());
+                break;
+            case 1: {
+                std::list<std::string> list(source.begin(), source.end());
+                values.append_range(list.begin(), list.end());
+                expected.insert(expected.end(), list.begin(), list.end());
+                break;
+            }
+            case 2:
+                if (gen() % 8 == 0) {
+                    values.assign(source.begin(), source.end());
+                    expected.assign(source.begin(), source.end());
+                }
+                break;
+            default: {
+                std::ostringstream stream;
+                for (const auto &value : source) {
+                    stream << value << ' ';
+                }
+                std::istringstream input(stream.str());
+                values.insert(values.begin() + index, std::istream_iterator<std::string>(input),
+                              std::istream_iterator<std::string>());
+                expected.insert(expected.begin() + index, source.begin(), source.end());
+                break;
+            }
+            }
+            REQUIRE(Same(values, expected));
+        }
+    }
+
+    SECTION("From the vector itself") {
+        Vector<std::string> values;
+        std::vector<std::string> expected;
+        for (int i = 0; i < 10; ++i) {
+            values.push_back(std::string(40, char('a' + i)));
+            expected.push_back(std::string(40, char('a' + i)));
+        }
+        for (int round = 0; round < 6; ++round) {
+            size_t index = round % 3 * expected.size() / 2;
+            values.insert(values.begin() + index, values.begin() + 1, values.end() - 1);
+            std::vector<std::string> copy(expected.begin() + 1, expected.end() - 1);
+            expected.insert(expected.begin() + index, copy.begin(), copy.end());
+            REQUIRE(Same(values, expected));
+        }
+        values.append_range(values.begin(), values.end());
+        std::vector<std::string> copy(expected);
+        expected.insert(expected.end(), copy.begin(), copy.end());
+        REQUIRE(Same(values, expected));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Aligned storage") {
+    Vector<float, AlignedAllocator<float, 64>> values;
+    for (int i = 0; i < 10000; ++i) {
+        values.push_back(i);
+        REQUIRE(reinterpret_cast<uintptr_t>(values.begin()) % 64 == 0);
+    }
+    values.shrink_to_fit();
+    REQUIRE(reinterpret_cast<uintptr_t>(values.begin()) % 64 == 0);
+
+    Vector<float, AlignedAllocator<float, 64>> copy(values);
+    REQUIRE(reinterpret_cast<uintptr_t>(copy.begin()) % 64 == 0);
+    REQUIRE(copy[9999] == 9999);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Random erase, emplace and emplace_back on Vector<T> and std::vector<int>,
+// with make turning an int into a T and value reading it back.
+template <typename T, typename Make, typename Value>
+void EraseAndEmplace(Make make, Value value) {
+    std::mt19937 gen(11);
+    Vector<T> values;
+    std::vector<int> expected;
+    auto same = [&] {
+        if (values.size() != expected.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < expected.size(); ++i) {
+            if (value(values[i]) != expected[i]) {
+                return false;
+            }
+        }
+        return true;
+    };
+    for (int step = 0; step < 3000; ++step) {
+        int x = gen() % 1000;
+        size_t index = gen() % (expected.size() + 1);
+        switch (gen() % 4) {
+        case 0: {
+            size_t last = index + gen() % (expected.size() - index + 1);
+            T *next = values.erase(values.begin() + index, values.begin() + last);
+            expected.erase(expected.begin() + index, expected.begin() + last);
+            REQUIRE(next == values.begin() + index);
+            break;
+        }
+        case 1: {
+            T *added = values.emplace(values.begin() + index, make(x));
+            expected.insert(expected.begin() + index, x);
+            REQUIRE(value(*added) == x);
+            break;
+        }
+        default:
+            REQUIRE(value(values.emplace_back(make(x))) == x);
+            expected.push_back(x);
+            break;
+        }
+        REQUIRE(same());
+    }
+
+    // At full capacity the argument is read before the storage moves.
+    values.clear();
+    values.emplace_back(make(7));
+    while (values.size() < values.capacity()) {
+        values.emplace_back(values[0]);
+    }
+    values.emplace_back(values[0]);
+    for (size_t i = 0; i < values.size(); ++i) {
+        REQUIRE(value(values[i]) == 7);
+    }
+}
+
+}  // namespace
+
+TEST_CASE("Erase and emplace") {
+    SECTION("Trivially copyable") {
+        EraseAndEmplace<int>([](int x) { return x; }, [](int x) { return x; });
+    }
+
+    SECTION("Trivially relocatable") {
+        EraseAndEmplace<SharedPtr<int>>([](int x) { return MakeShared<int>(x); },
+                                        [](const SharedPtr<int> &p) { return *p; });
+        SharedPtr<int> shared = MakeShared<int>(1);
+        {
+            Vector<SharedPtr<int>> values(10, shared);
+            values.erase(values.begin() + 2, values.begin() + 5);
+            REQUIRE(shared.UseCount() == 8);
+        }
+        REQUIRE(shared.UseCount() == 1);
+    }
+
+    SECTION("Not relocatable") {
+        EraseAndEmplace<std::string>(
+            [](int x) { return std::to_string(x) + std::string(30, '.'); },
+            [](const std::string &s) { return std::stoi(s); });
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Element types used only by the stats test, so their counters start at zero.
+struct Counted {
+    int64_t value;
+};
+
+struct Remapped {
+    int64_t value;
+};
+
+}  // namespace
+
+TEST_CASE("Memory stats") {
+    SECTION("Growth and shrink_to_fit") {
+        VectorTypeStats &stats = VectorStats::Get<Counted>();
+        uint64_t allocations = 0;
+        uint64_t reallocations = 0;
+        uint64_t moved = 0;
+        {
+            Vector<Counted> values;
+            for (int64_t i = 0; i < 1000; ++i) {
+                size_t capacity = values.capacity();
+                values.push_back({i});
+                if (values.capacity() != capacity) {
+                    ++allocations;
+                    if (capacity != 0) {
+                        ++reallocations;
+                        moved += i * sizeof(Counted);
+                    }
+                }
+                REQUIRE(stats.live_bytes == int64_t(values.capacity() * sizeof(Counted)));
+                REQUIRE(stats.used_bytes == int64_t(values.size() * sizeof(Counted)));
+            }
+            REQUIRE(stats.allocations == allocations);
+            REQUIRE(stats.reallocations == reallocations);
+            REQUIRE(stats.bytes_moved == moved);
+
+            values.resize(600);
+            REQUIRE(stats.used_bytes == int64_t(600 * sizeof(Counted)));
+            values.shrink_to_fit();
+            REQUIRE(values.capacity() == 600);
+            REQUIRE(stats.live_bytes == int64_t(600 * sizeof(Counted)));
+            REQUIRE(stats.allocations == allocations + 1);
+            REQUIRE(stats.reallocations == reallocations + 1);
+            REQUIRE(stats.bytes_moved == moved + 600 * sizeof(Counted));
+        }
+        REQUIRE(stats.live_bytes == 0);
+        REQUIRE(stats.used_bytes == 0);
+    }
+
+    SECTION("Resized in place") {
+        VectorTypeStats &stats = VectorStats::Get<Remapped>();
+        {
+            Vector<Remapped, ReallocAllocator<Remapped>> values;
+            for (int64_t i = 0; i < 100000; ++i) {
+                values.push_back({i});
+            }
+            REQUIRE(stats.allocations == 1);
+            REQUIRE(stats.reallocations > 1);
+            REQUIRE(stats.bytes_moved == 0);
+            REQUIRE(stats.live_bytes == int64_t(values.capacity() * sizeof(Remapped)));
+        }
+        REQUIRE(stats.live_bytes == 0);
+    }
+
+    SECTION("Report") {
+        {
+            Vector<Counted> values(10);
+            std::ostringstream out;
+            VectorStats::Report(out);
+            std::string report = out.str();
+            REQUIRE(report.rfind("type\telement\tlive\tused\tslack", 0) == 0);
+            std::string line = std::string(typeid(Counted).name()) + "\t8\t80\t80\t0\t";
+            REQUIRE(report.find(line) != std::string::npos);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Capacities a Vector with the given growth policy passes through while n
+// elements are pushed, checking the contents along the way.
+template <typename Growth>
+std::vector<size_t> Capacities(int n) {
+    Vector<std::string, std::allocator<std::string>, Growth> values;
+    std::vector<size_t> capacities;
+    for (int i = 0; i < n; ++i) {
+        values.push_back(std::to_string(i));
+        if (capacities.empty() || capacities.back() != values.capacity()) {
+            capacities.push_back(values.capacity());
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        REQUIRE(values[i] == std::to_string(i));
+    }
+    return capacities;
+}
+
+}  // namespace
+
+TEST_CASE("Growth policies") {
+    REQUIRE(Capacities<DoublingGrowth>(100) ==
+            std::vector<size_t>{1, 2, 4, 8, 16, 32, 64, 128});
+    REQUIRE(Capacities<HalfGrowth>(100) ==
+            std::vector<size_t>{1, 2, 3, 4, 6, 9, 13, 19, 28, 42, 63, 94, 141});
+    REQUIRE(Capacities<FixedGrowth<16>>(100) ==
+            std::vector<size_t>{16, 32, 48, 64, 80, 96, 112});
+}
@@ -0,0 +1,789 @@
+#pragma once
+
+#include "Vector.cpp"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define VECTOR_ALGORITHMS_X86 1
+#endif
+
+// Vectorized find/count/min/max/sum over Vector of arithmetic types. 32- and
+// 64-bit signed integers, floats and doubles get SSE2 kernels, upgraded to
+// AVX2 at runtime when the CPU has it; every other type, and every other
+// platform, uses the scalar loops below.
+namespace simd {
+
+template <typename T>
+using SumType = std::conditional_t<std::is_floating_point_v<T>, double,
+                                   std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+namespace detail {
+
+template <typename T>
+size_t FindScalar(const T *data, size_t n, T value) {
+    for (size_t i = 0; i < n; ++i) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return n;
+}
+
+template <typename T>
+size_t CountScalar(const T *data, size_t n, T value) {
+    size_t total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        total += data[i] == value;
+    }
+    return total;
+}
+
+template <typename T>
+T MinScalar(const T *data, size_t n) {
+    T result = data[0];
+    for (size_t i = 1; i < n; ++i) {
+        result = data[i] < result ? data[i] : result;
+    }
+    return result;
+}
+
+template <typename T>
+T MaxScalar(const T *data, size_t n) {
+    T result = data[0];
+    for (size_t i = 1; i < n; ++i) {
+        result = result < data[i] ? data[i] : result;
+    }
+    return result;
+}
+
+template <typename T>
+SumType<T> SumScalar(const T *data, size_t n) {
+    SumType<T> total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        total += data[i];
+    }
+    return total;
+}
+
+#ifdef VECTOR_ALGORITHMS_X86
+
+inline bool HasAvx2() {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+
+// Lane counters are flushed to size_t before they can overflow.
+constexpr size_t kCountFlush = size_t(1) << 28;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// SSE2, always available on x86-64
+
+inline size_t FindSse2(const int32_t *data, size_t n, int32_t value) {
+    __m128i needle = _mm_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, needle)));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + FindScalar(data + i, n - i, value);
+}
+
+inline size_t FindSse2(const float *data, size_t n, float value) {
+    __m128 needle = _mm_set1_ps(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int mask = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(data + i), needle));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + FindScalar(data + i, n - i, value);
+}
+
+inline size_t CountSse2(const int32_t *data, size_t n, int32_t value) {
+    __m128i needle = _mm_set1_epi32(value);
+    size_t total = 0;
+    size_t i = 0;
+    while (i + 4 <= n) {
+        size_t stop = n - i > 4 * kCountFlush ? i + 4 * kCountFlush : n;
+        __m128i counts = _mm_setzero_si128();
+        for (; i + 4 <= stop; i += 4) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            counts = _mm_sub_epi32(counts, _mm_cmpeq_epi32(block, needle));
+        }
+        alignas(16) uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), counts);
+        total += size_t(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+    return total + CountScalar(data + i, n - i, value);
+}
+
+inline size_t CountSse2(const float *data, size_t n, float value) {
+    __m128 needle = _mm_set1_ps(value);
+    size_t total = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        total += __builtin_popcount(_mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(data + i), needle)));
+    }
+    return total + CountScalar(data + i, n - i, value);
+}
+
+inline int32_t MinSse2(const int32_t *data, size_t n) {
+    if (n < 4) {
+        return MinScalar(data, n);
+    }
+    __m128i result = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i less = _mm_cmplt_epi32(block, result);
+        result = _mm_or_si128(_mm_and_si128(less, block), _mm_andnot_si128(less, result));
+    }
+    alignas(16) int32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), result);
+    int32_t tail = i < n ? MinScalar(data + i, n - i) : lanes[0];
+    return MinScalar(lanes, 4) < tail ? MinScalar(lanes, 4) : tail;
+}
+
+inline int32_t MaxSse2(const int32_t *data, size_t n) {
+    if (n < 4) {
+        return MaxScalar(data, n);
+    }
+    __m128i result = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i greater = _mm_cmpgt_epi32(block, result);
+        result = _mm_or_si128(_mm_and_si128(greater, block), _mm_andnot_si128(greater, result));
+    }
+    alignas(16) int32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), result);
+    int32_t tail = i < n ? MaxScalar(data + i, n - i) : lanes[0];
+    return MaxScalar(lanes, 4) < tail ? tail : MaxScalar(lanes, 4);
+}
+
+inline float MinSse2(const float *data, size_t n) {
+    if (n < 4) {
+        return MinScalar(data, n);
+    }
+    __m128 result = _mm_loadu_ps(data);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        result = _mm_min_ps(_mm_loadu_ps(data + i), result);
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, result);
+    float tail = i < n ? MinScalar(data + i, n - i) : lanes[0];
+    return MinScalar(lanes, 4) < tail ? MinScalar(lanes, 4) : tail;
+}
+
+inline float MaxSse2(const float *data, size_t n) {
+    if (n < 4) {
+        return MaxScalar(data, n);
+    }
+    __m128 result = _mm_loadu_ps(data);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        result = _mm_max_ps(_mm_loadu_ps(data + i), result);
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, result);
+    float tail = i < n ? MaxScalar(data + i, n - i) : lanes[0];
+    return MaxScalar(lanes, 4) < tail ? tail : MaxScalar(lanes, 4);
+}
+
+inline int64_t SumSse2(const int32_t *data, size_t n) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i total = zero;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i sign = _mm_cmpgt_epi32(zero, block);
+        total = _mm_add_epi64(total, _mm_unpacklo_epi32(block, sign));
+        total = _mm_add_epi64(total, _mm_unpackhi_epi32(block, sign));
+    }
+    alignas(16) int64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), total);
+    return lanes[0] + lanes[1] + SumScalar(data + i, n - i);
+}
+
+inline double SumSse2(const float *data, size_t n) {
+    __m128d total = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 block = _mm_loadu_ps(data + i);
+        total = _mm_add_pd(total, _mm_cvtps_pd(block));
+        total = _mm_add_pd(total, _mm_cvtps_pd(_mm_movehl_ps(block, block)));
+    }
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, total);
+    return lanes[0] + lanes[1] + SumScalar(data + i, n - i);
+}
+
+// SSE2 has no 64-bit compares; these build them from 32-bit ones.
+inline __m128i CmpEq64Sse2(__m128i a, __m128i b) {
+    __m128i equal = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(equal, _mm_shuffle_epi32(equal, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+// Signed a > b: the high halves decide unless they are equal, in which case
+// the borrow of b - a says whether the low half of a is larger.
+inline __m128i CmpGt64Sse2(__m128i a, __m128i b) {
+    __m128i greater = _mm_and_si128(_mm_cmpeq_epi32(a, b), _mm_sub_epi64(b, a));
+    greater = _mm_or_si128(greater, _mm_cmpgt_epi32(a, b));
+    return _mm_shuffle_epi32(greater, _MM_SHUFFLE(3, 3, 1, 1));
+}
+
+inline __m128i Select64Sse2(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+inline size_t FindSse2(const int64_t *data, size_t n, int64_t value) {
+    __m128i needle = _mm_set1_epi64x(value);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        int mask = _mm_movemask_pd(_mm_castsi128_pd(CmpEq64Sse2(block, needle)));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + FindScalar(data + i, n - i, value);
+}
+
+inline size_t FindSse2(const double *data, size_t n, double value) {
+    __m128d needle = _mm_set1_pd(value);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        int mask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(data + i), needle));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + FindScalar(data + i, n - i, value);
+}
+
+inline size_t CountSse2(const int64_t *data, size_t n, int64_t value) {
+    __m128i needle = _mm_set1_epi64x(value);
+    __m128i counts = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        counts = _mm_sub_epi64(counts, CmpEq64Sse2(block, needle));
+    }
+    alignas(16) uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), counts);
+    return lanes[0] + lanes[1] + CountScalar(data + i, n - i, value);
+}
+
+inline size_t CountSse2(const double *data, size_t n, double value) {
+    __m128d needle = _mm_set1_pd(value);
+    size_t total = 0;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        total += __builtin_popcount(_mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(data + i), needle)));
+    }
+    return total + CountScalar(data + i, n - i, value);
+}
+
+inline int64_t MinSse2(const int64_t *data, size_t n) {
+    if (n < 2) {
+        return MinScalar(data, n);
+    }
+    __m128i result = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    size_t i = 2;
+    for (; i + 2 <= n; i += 2) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        result = Select64Sse2(CmpGt64Sse2(result, block), block, result);
+    }
+    alignas(16) int64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), result);
+    int64_t tail = i < n ? MinScalar(data + i, n - i) : lanes[0];
+    return MinScalar(lanes, 2) < tail ? MinScalar(lanes, 2) : tail;
+}
+
+inline int64_t MaxSse2(const int64_t *data, size_t n) {
+    if (n < 2) {
+        return MaxScalar(data, n);
+    }
+    __m128i result = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    size_t i = 2;
+    for (; i + 2 <= n; i += 2) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        result = Select64Sse2(CmpGt64Sse2(block, result), block, result);
+    }
+    alignas(16) int64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), result);
+    int64_t tail = i < n ? MaxScalar(data + i, n - i) : lanes[0];
+    return MaxScalar(lanes, 2) < tail ? tail : MaxScalar(lanes, 2);
+}
+
+inline double MinSse2(const double *data, size_t n) {
+    if (n < 2) {
+        return MinScalar(data, n);
+    }
+    __m128d result = _mm_loadu_pd(data);
+    size_t i = 2;
+    for (; i + 2 <= n; i += 2) {
+        result = _mm_min_pd(_mm_loadu_pd(data + i), result);
+    }
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, result);
+    double tail = i < n ? MinScalar(data + i, n - i) : lanes[0];
+    return MinScalar(lanes, 2) < tail ? MinScalar(lanes, 2) : tail;
+}
+
+inline double MaxSse2(const double *data, size_t n) {
+    if (n < 2) {
+        return MaxScalar(data, n);
+    }
+    __m128d result = _mm_loadu_pd(data);
+    size_t i = 2;
+    for (; i + 2 <= n; i += 2) {
+        result = _mm_max_pd(_mm_loadu_pd(data + i), result);
+    }
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, result);
+    double tail = i < n ? MaxScalar(data + i, n - i) : lanes[0];
+    return MaxScalar(lanes, 2) < tail ? tail : MaxScalar(lanes, 2);
+}
+
+// Wraps on overflow like the scalar loop does in practice.
+inline int64_t SumSse2(const int64_t *data, size_t n) {
+    __m128i total = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        total = _mm_add_epi64(total, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+    }
+    alignas(16) uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), total);
+    return int64_t(lanes[0] + lanes[1] + uint64_t(SumScalar(data + i, n - i)));
+}
+
+inline double SumSse2(const double *data, size_t n) {
+    __m128d total = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        total = _mm_add_pd(total, _mm_loadu_pd(data + i));
+    }
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, total);
+    return lanes[0] + lanes[1] + SumScalar(data + i, n - i);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// AVX2, picked at runtime
+
+__attribute__((target("avx2"))) inline size_t FindAvx2(const int32_t *data, size_t n,
+                                                       int32_t value) {
+    __m256i needle = _mm256_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(block, needle)));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + FindScalar(data + i, n - i, value);
+}
+
+__attribute__((target("avx2"))) inline size_t FindAvx2(const float *data, size_t n,
+                                                       float value) {
+    __m256 needle = _mm256_set1_ps(value);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 equal = _mm256_cmp_ps(_mm256_loadu_ps(data + i), needle, _CMP_EQ_OQ);
+        int mask = _mm256_movemask_ps(equal);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + FindScalar(data + i, n - i, value);
+}
+
+__attribute__((target("avx2"))) inline size_t CountAvx2(const int32_t *data, size_t n,
+                                                        int32_t value) {
+    __m256i needle = _mm256_set1_epi32(value);
+    size_t total = 0;
+    size_t i = 0;
+    while (i + 8 <= n) {
+        size_t stop = n - i > 8 * kCountFlush ? i + 8 * kCountFlush : n;
+        __m256i counts = _mm256_setzero_si256();
+        for (; i + 8 <= stop; i += 8) {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            counts = _mm256_sub_epi32(counts, _mm256_cmpeq_epi32(block, needle));
+        }
+        alignas(32) uint32_t lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), counts);
+        for (uint32_t lane : lanes) {
+            total += lane;
+        }
+    }
+    return total + CountScalar(data + i, n - i, value);
+}
+
+__attribute__((target("avx2"))) inline size_t CountAvx2(const float *data, size_t n,
+                                                        float value) {
+    __m256 needle = _mm256_set1_ps(value);
+    size_t total = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 equal = _mm256_cmp_ps(_mm256_loadu_ps(data + i), needle, _CMP_EQ_OQ);
+        total += __builtin_popcount(_mm256_movemask_ps(equal));
+    }
+    return total + CountScalar(data + i, n - i, value);
+}
+
+__attribute__((target("avx2"))) inline int32_t MinAvx2(const int32_t *data, size_t n) {
+    if (n < 8) {
+        return MinScalar(data, n);
+    }
+    __m256i result = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        result = _mm256_min_epi32(
+            result, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+    }
+    alignas(32) int32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), result);
+    int32_t tail = i < n ? MinScalar(data + i, n - i) : lanes[0];
+    return MinScalar(lanes, 8) < tail ? MinScalar(lanes, 8) : tail;
+}
+
+__attribute__((target("avx2"))) inline int32_t MaxAvx2(const int32_t *data, size_t n) {
+    if (n < 8) {
+        return MaxScalar(data, n);
+    }
+    __m256i result = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        result = _mm256_max_epi32(
+            result, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+    }
+    alignas(32) int32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), result);
+    int32_t tail = i < n ? MaxScalar(data + i, n - i) : lanes[0];
+    return MaxScalar(lanes, 8) < tail ? tail : MaxScalar(lanes, 8);
+}
+
+__attribute__((target("avx2"))) inline float MinAvx2(const float *data, size_t n) {
+    if (n < 8) {
+        return MinScalar(data, n);
+    }
+    __m256 result = _mm256_loadu_ps(data);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        result = _mm256_min_ps(_mm256_loadu_ps(data + i), result);
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, result);
+    float tail = i < n ? MinScalar(data + i, n - i) : lanes[0];
+    return MinScalar(lanes, 8) < tail ? MinScalar(lanes, 8) : tail;
+}
+
+__attribute__((target("avx2"))) inline float MaxAvx2(const float *data, size_t n) {
+    if (n < 8) {
+        return MaxScalar(data, n);
+    }
+    __m256 result = _mm256_loadu_ps(data);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        result = _mm256_max_ps(_mm256_loadu_ps(data + i), result);
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, result);
+    float tail = i < n ? MaxScalar(data + i, n - i) : lanes[0];
+    return MaxScalar(lanes, 8) < tail ? tail : MaxScalar(lanes, 8);
+}
+
+__attribute__((target("avx2"))) inline int64_t SumAvx2(const int32_t *data, size_t n) {
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        total = _mm256_add_epi64(total, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(block)));
+        total = _mm256_add_epi64(total, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(block, 1)));
+    }
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), total);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + SumScalar(data + i, n - i);
+}
+
+__attribute__((target("avx2"))) inline double SumAvx2(const float *data, size_t n) {
+    __m256d total = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 block = _mm256_loadu_ps(data + i);
+        total = _mm256_add_pd(total, _mm256_cvtps_pd(_mm256_castps256_ps128(block)));
+        total = _mm256_add_pd(total, _mm256_cvtps_pd(_mm256_extractf128_ps(block, 1)));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, total);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + SumScalar(data + i, n - i);
+}
+
+__attribute__((target("avx2"))) inline size_t FindAvx2(const int64_t *data, size_t n,
+                                                       int64_t value) {
+    __m256i needle = _mm256_set1_epi64x(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(block, needle)));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + FindScalar(data + i, n - i, value);
+}
+
+__attribute__((target("avx2"))) inline size_t FindAvx2(const double *data, size_t n,
+                                                       double value) {
+    __m256d needle = _mm256_set1_pd(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d equal = _mm256_cmp_pd(_mm256_loadu_pd(data + i), needle, _CMP_EQ_OQ);
+        int mask = _mm256_movemask_pd(equal);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + FindScalar(data + i, n - i, value);
+}
+
+__attribute__((target("avx2"))) inline size_t CountAvx2(const int64_t *data, size_t n,
+                                                        int64_t value) {
+    __m256i needle = _mm256_set1_epi64x(value);
+    __m256i counts = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        counts = _mm256_sub_epi64(counts, _mm256_cmpeq_epi64(block, needle));
+    }
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), counts);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + CountScalar(data + i, n - i, value);
+}
+
+__attribute__((target("avx2"))) inline size_t CountAvx2(const double *data, size_t n,
+                                                        double value) {
+    __m256d needle = _mm256_set1_pd(value);
+    size_t total = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d equal = _mm256_cmp_pd(_mm256_loadu_pd(data + i), needle, _CMP_EQ_OQ);
+        total += __builtin_popcount(_mm256_movemask_pd(equal));
+    }
+    return total + CountScalar(data + i, n - i, value);
+}
+
+__attribute__((target("avx2"))) inline int64_t MinAvx2(const int64_t *data, size_t n) {
+    if (n < 4) {
+        return MinScalar(data, n);
+    }
+    __m256i result = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        result = _mm256_blendv_epi8(result, block, _mm256_cmpgt_epi64(result, block));
+    }
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), result);
+    int64_t tail = i < n ? MinScalar(data + i, n - i) : lanes[0];
+    return MinScalar(lanes, 4) < tail ? MinScalar(lanes, 4) : tail;
+}
+
+__attribute__((target("avx2"))) inline int64_t MaxAvx2(const int64_t *data, size_t n) {
+    if (n < 4) {
+        return MaxScalar(data, n);
+    }
+    __m256i result = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        result = _mm256_blendv_epi8(result, block, _mm256_cmpgt_epi64(block, result));
+    }
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), result);
+    int64_t tail = i < n ? MaxScalar(data + i, n - i) : lanes[0];
+    return MaxScalar(lanes, 4) < tail ? tail : MaxScalar(lanes, 4);
+}
+
+__attribute__((target("avx2"))) inline double MinAvx2(const double *data, size_t n) {
+    if (n < 4) {
+        return MinScalar(data, n);
+    }
+    __m256d result = _mm256_loadu_pd(data);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        result = _mm256_min_pd(_mm256_loadu_pd(data + i), result);
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, result);
+    double tail = i < n ? MinScalar(data + i, n - i) : lanes[0];
+    return MinScalar(lanes, 4) < tail ? MinScalar(lanes, 4) : tail;
+}
+
+__attribute__((target("avx2"))) inline double MaxAvx2(const double *data, size_t n) {
+    if (n < 4) {
+        return MaxScalar(data, n);
+    }
+    __m256d result = _mm256_loadu_pd(data);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        result = _mm256_max_pd(_mm256_loadu_pd(data + i), result);
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, result);
+    double tail = i < n ? MaxScalar(data + i, n - i) : lanes[0];
+    return MaxScalar(lanes, 4) < tail ? tail : MaxScalar(lanes, 4);
+}
+
+__attribute__((target("avx2"))) inline int64_t SumAvx2(const int64_t *data, size_t n) {
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        total = _mm256_add_epi64(
+            total, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+    }
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), total);
+    return int64_t(lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+                   uint64_t(SumScalar(data + i, n - i)));
+}
+
+__attribute__((target("avx2"))) inline double SumAvx2(const double *data, size_t n) {
+    __m256d total = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        total = _mm256_add_pd(total, _mm256_loadu_pd(data + i));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, total);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + SumScalar(data + i, n - i);
+}
+
+// The types with SIMD kernels.
+template <typename T>
+inline constexpr bool kHasKernels = std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+                                    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+#endif  // VECTOR_ALGORITHMS_X86
+
+template <typename T>
+size_t Find(const T *data, size_t n, T value) {
+#ifdef VECTOR_ALGORITHMS_X86
+    if constexpr (kHasKernels<T>) {
+        return HasAvx2() ? FindAvx2(data, n, value) : FindSse2(data, n, value);
+    }
+#endif
+    return FindScalar(data, n, value);
+}
+
+template <typename T>
+size_t Count(const T *data, size_t n, T value) {
+#ifdef VECTOR_ALGORITHMS_X86
+    if constexpr (kHasKernels<T>) {
+        return HasAvx2() ? CountAvx2(data, n, value) : CountSse2(data, n, value);
+    }
+#endif
+    return CountScalar(data, n, value);
+}
+
+template <typename T>
+T Min(const T *data, size_t n) {
+#ifdef VECTOR_ALGORITHMS_X86
+    if constexpr (kHasKernels<T>) {
+        return HasAvx2() ? MinAvx2(data, n) : MinSse2(data, n);
+    }
+#endif
+    return MinScalar(data, n);
+}
+
+template <typename T>
+T Max(const T *data, size_t n) {
+#ifdef VECTOR_ALGORITHMS_X86
+    if constexpr (kHasKernels<T>) {
+        return HasAvx2() ? MaxAvx2(data, n) : MaxSse2(data, n);
+    }
+#endif
+    return MaxScalar(data, n);
+}
+
+template <typename T>
+SumType<T> Sum(const T *data, size_t n) {
+#ifdef VECTOR_ALGORITHMS_X86
+    if constexpr (kHasKernels<T>) {
+        return HasAvx2() ? SumAvx2(data, n) : SumSse2(data, n);
+    }
+#endif
+    return SumScalar(data, n);
+}
+
+}  // namespace detail
+
+// Pointer to the first element equal to value, or vector.end().
+template <typename T, typename Alloc, typename Growth>
+const T* find(const Vector<T, Alloc, Growth> &vector, T value) {
+    static_assert(std::is_arithmetic_v<T>);
+    return vector.begin() + detail::Find(vector.begin(), vector.size(), value);
+}
+
+template <typename T, typename Alloc, typename Growth>
+size_t count(const Vector<T, Alloc, Growth> &vector, T value) {
+    static_assert(std::is_arithmetic_v<T>);
+    return detail::Count(vector.begin(), vector.size(), value);
+}
+
+// min and max need a non-empty vector. With NaNs among floats the result is
+// unspecified.
+template <typename T, typename Alloc, typename Growth>
+T min(const Vector<T, Alloc, Growth> &vector) {
+    static_assert(std::is_arithmetic_v<T>);
+    return detail::Min(vector.begin(), vector.size());
+}
+
+template <typename T, typename Alloc, typename Growth>
+T max(const Vector<T, Alloc, Growth> &vector) {
+    static_assert(std::is_arithmetic_v<T>);
+    return detail::Max(vector.begin(), vector.size());
+}
+
+// Integers are summed in 64 bits and floats in double. The SIMD kernels add
+// floating values in a different order than a plain loop, so the last bits
+// may differ.
+template <typename T, typename Alloc, typename Growth>
+SumType<T> sum(const Vector<T, Alloc, Growth> &vector) {
+    static_assert(std::is_arithmetic_v<T>);
+    return detail::Sum(vector.begin(), vector.size());
+}
+
+// out[i] = op(in[i]). The loop is written over non-aliasing raw pointers so
+// the compiler vectorizes it for simple ops; out may be the same vector as in.
+template <typename T, typename Alloc, typename Growth, typename U, typename UAlloc,
+          typename UGrowth, typename Op>
+void transform(const Vector<T, Alloc, Growth> &in, Vector<U, UAlloc, UGrowth> &out, Op op) {
+    static_assert(std::is_arithmetic_v<T> && std::is_arithmetic_v<U>);
+    size_t n = in.size();
+    if (static_cast<const void*>(&in) != static_cast<const void*>(&out)) {
+        out.resize(n);
+        const T *__restrict from = in.begin();
+        U *__restrict to = out.begin();
+        for (size_t i = 0; i < n; ++i) {
+            to[i] = op(from[i]);
+        }
+    } else {
+        U *data = out.begin();
+        for (size_t i = 0; i < n; ++i) {
+            data[i] = op(data[i]);
+        }
+    }
+}
+
+}  // namespace simd
@@ -0,0 +1,97 @@
+#include "../vector_algorithms.h"
+
+#include <catch.hpp>
+
+#include <limits>
+#include <random>
+
+namespace {
+
+// Checks every kernel the CPU can run against the scalar loops, for lengths
+// around the vector widths and values with many repeats.
+template <typename T>
+void CheckKernels() {
+    std::mt19937_64 gen(17);
+    for (size_t n : {size_t(1), size_t(2), size_t(3), size_t(5), size_t(8), size_t(9),
+                     size_t(31), size_t(1000), size_t(4099)}) {
+        Vector<T> values;
+        for (size_t i = 0; i < n; ++i) {
+            T value;
+            if constexpr (std::is_floating_point_v<T>) {
+                value = T(int64_t(gen() % 201) - 100) / 4;
+            } else {
+                // Mixes small values with ones whose high halves differ,
+                // kept small enough that the sums cannot overflow.
+                value = gen() % 2 ? T(int64_t(gen() % 201) - 100) : T(int64_t(gen()) >> 20);
+            }
+            values.push_back(value);
+        }
+        const T *data = values.begin();
+        T needle = values[n / 2];
+        T missing = std::numeric_limits<T>::lowest();
+
+        REQUIRE(simd::detail::Find(data, n, needle) == simd::detail::FindScalar(data, n, needle));
+        REQUIRE(simd::detail::Find(data, n, missing) == n);
+        REQUIRE(simd::detail::Count(data, n, needle) ==
+                simd::detail::CountScalar(data, n, needle));
+        REQUIRE(simd::detail::Min(data, n) == simd::detail::MinScalar(data, n));
+        REQUIRE(simd::detail::Max(data, n) == simd::detail::MaxScalar(data, n));
+
+#ifdef VECTOR_ALGORITHMS_X86
+        REQUIRE(simd::detail::FindSse2(data, n, needle) ==
+                simd::detail::FindScalar(data, n, needle));
+        REQUIRE(simd::detail::CountSse2(data, n, needle) ==
+                simd::detail::CountScalar(data, n, needle));
+        REQUIRE(simd::detail::MinSse2(data, n) == simd::detail::MinScalar(data, n));
+        REQUIRE(simd::detail::MaxSse2(data, n) == simd::detail::MaxScalar(data, n));
+        // Floating values are quarters, which add exactly in any order.
+        REQUIRE(simd::detail::SumSse2(data, n) == simd::detail::SumScalar(data, n));
+        if (simd::detail::HasAvx2()) {
+            REQUIRE(simd::detail::FindAvx2(data, n, needle) ==
+                    simd::detail::FindScalar(data, n, needle));
+            REQUIRE(simd::detail::CountAvx2(data, n, needle) ==
+                    simd::detail::CountScalar(data, n, needle));
+            REQUIRE(simd::detail::MinAvx2(data, n) == simd::detail::MinScalar(data, n));
+            REQUIRE(simd::detail::MaxAvx2(data, n) == simd::detail::MaxScalar(data, n));
+            REQUIRE(simd::detail::SumAvx2(data, n) == simd::detail::SumScalar(data, n));
+        }
+#endif
+    }
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Kernels match the scalar loops") {
+    SECTION("int32_t") {
+        CheckKernels<int32_t>();
+    }
+    SECTION("int64_t") {
+        CheckKernels<int64_t>();
+    }
+    SECTION("float") {
+        CheckKernels<float>();
+    }
+    SECTION("double") {
+        CheckKernels<double>();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Vector interface") {
+    Vector<int64_t> values;
+    for (int64_t i = 0; i < 100; ++i) {
+        values.push_back(i % 10 - (int64_t(1) << 40));
+    }
+    REQUIRE(simd::find(values, int64_t(3) - (int64_t(1) << 40)) == values.begin() + 3);
+    REQUIRE(simd::count(values, int64_t(3) - (int64_t(1) << 40)) == 10);
+    REQUIRE(simd::min(values) == -(int64_t(1) << 40));
+    REQUIRE(simd::max(values) == 9 - (int64_t(1) << 40));
+    REQUIRE(simd::sum(values) == 450 - 100 * (int64_t(1) << 40));
+
+    Vector<double> doubles;
+    simd::transform(values, doubles, [](int64_t value) { return double(value % 10); });
+    REQUIRE(simd::sum(doubles) == -450);
+}
@@ -0,0 +1,323 @@
+#pragma once
+
+#include "Vector.cpp"
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Binary format: every vector is a VectorIoHeader followed by its payload.
+// A vector of trivially copyable elements stores them as raw bytes, a vector
+// of vectors stores its elements one after another. Data is written in host
+// byte order and layout, so it is meant for processes on the same platform.
+struct VectorIoHeader {
+    uint64_t count;
+    uint64_t element_size;  // 0 for a vector of vectors
+};
+
+template <typename T>
+struct IsVector : std::false_type {};
+
+template <typename T, typename Alloc, typename Growth>
+struct IsVector<Vector<T, Alloc, Growth>> : std::true_type {};
+
+namespace vector_io {
+
+inline void WriteAll(int fd, iovec *iov, size_t count) {
+#ifdef IOV_MAX
+    const size_t kMaxBatch = IOV_MAX;
+#else
+    const size_t kMaxBatch = 1024;
+#endif
+    while (count > 0) {
+        ssize_t written = writev(fd, iov, count < kMaxBatch ? count : kMaxBatch);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "vector_io: writev");
+        }
+        size_t left = written;
+        while (count > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+            iov->iov_len -= left;
+        }
+    }
+}
+
+inline void ReadAll(int fd, void *buffer, size_t bytes) {
+    char *to = static_cast<char*>(buffer);
+    while (bytes > 0) {
+        ssize_t got = read(fd, to, bytes);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "vector_io: read");
+        }
+        if (got == 0) {
+            throw std::runtime_error("vector_io: unexpected end of stream");
+        }
+        to += got;
+        bytes -= got;
+    }
+}
+
+template <typename T>
+void CheckLeaf() {
+    static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable payloads");
+}
+
+template <typename V>
+size_t CountHeaders(const V &vector) {
+    using Element = std::remove_cv_t<std::remove_reference_t<decltype(vector[0])>>;
+    size_t total = 1;
+    if constexpr (IsVector<Element>::value) {
+        for (size_t i = 0; i < vector.size(); ++i) {
+            total += CountHeaders(vector[i]);
+        }
+    }
+    return total;
+}
+
+// Fills headers and iovecs in pre-order; headers must not reallocate meanwhile.
+template <typename V>
+void Collect(const V &vector, Vector<VectorIoHeader> &headers, Vector<iovec> &iov) {
+    using Element = std::remove_cv_t<std::remove_reference_t<decltype(vector[0])>>;
+    if constexpr (IsVector<Element>::value) {
+        headers.push_back({vector.size(), 0});
+        iov.push_back({&headers[headers.size() - 1], sizeof(VectorIoHeader)});
+        for (size_t i = 0; i < vector.size(); ++i) {
+            Collect(vector[i], headers, iov);
+        }
+    } else {
+        CheckLeaf<Element>();
+        headers.push_back({vector.size(), sizeof(Element)});
+        iov.push_back({&headers[headers.size() - 1], sizeof(VectorIoHeader)});
+        if (vector.size() != 0) {
+            iov.push_back({const_cast<Element*>(vector.begin()), vector.size() * sizeof(Element)});
+        }
+    }
+}
+
+inline void Check(const VectorIoHeader &header, uint64_t element_size) {
+    if (header.element_size != element_size) {
+        throw std::runtime_error("vector_io: element type does not match the stream");
+    }
+}
+
+}  // namespace vector_io
+
+// Writes the vector, nested vectors included, with as few writev calls as
+// IOV_MAX allows: one for a flat vector.
+template <typename T, typename Alloc, typename Growth>
+void WriteVector(int fd, const Vector<T, Alloc, Growth> &vector) {
+    Vector<VectorIoHeader> headers;
+    headers.reserve(vector_io::CountHeaders(vector));
+    Vector<iovec> iov;
+    vector_io::Collect(vector, headers, iov);
+    vector_io::WriteAll(fd, iov.begin(), iov.size());
+}
+
+// Reads a vector written by WriteVector. Flat payloads land with one read
+// straight into the vector's storage.
+template <typename V>
+V ReadVector(int fd) {
+    static_assert(IsVector<V>::value);
+    using Element = std::remove_cv_t<std::remove_reference_t<decltype(std::declval<V&>()[0])>>;
+
+    VectorIoHeader header;
+    vector_io::ReadAll(fd, &header, sizeof(header));
+    V vector;
+    if constexpr (IsVector<Element>::value) {
+        vector_io::Check(header, 0);
+        vector.resize(header.count);
+        for (size_t i = 0; i < header.count; ++i) {
+            Element element = ReadVector<Element>(fd);
+            vector[i].swap(element);
+        }
+    } else {
+        vector_io::CheckLeaf<Element>();
+        vector_io::Check(header, sizeof(Element));
+        vector.resize_for_overwrite(header.count);
+        vector_io::ReadAll(fd, vector.begin(), header.count * sizeof(Element));
+    }
+    return vector;
+}
+
+// Read-only window over a serialized flat vector inside a memory buffer, for
+// example an mmap'd file. The buffer must outlive the view.
+template <typename T>
+class VectorView {
+    const T *data;
+    size_t count;
+
+public:
+    VectorView(const T *data = nullptr, size_t count = 0) : data(data), count(count) {
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    const T* begin() const {
+        return data;
+    }
+
+    const T* end() const {
+        return data + count;
+    }
+
+    const T& operator[](size_t index) const {
+        return data[index];
+    }
+};
+
+// Views the flat vector starting at cursor and moves cursor past it. The
+// payload must be suitably aligned for T, which holds for buffers written by
+// WriteVector at an aligned offset when alignof(T) <= 16.
+template <typename T>
+VectorView<T> ViewVector(const char *&cursor, const char *end) {
+    vector_io::CheckLeaf<T>();
+    VectorIoHeader header;
+    if (static_cast<size_t>(end - cursor) < sizeof(header)) {
+        throw std::runtime_error("vector_io: buffer too short");
+    }
+    std::memcpy(&header, cursor, sizeof(header));
+    vector_io::Check(header, sizeof(T));
+    const char *payload = cursor + sizeof(header);
+    if (header.count > static_cast<size_t>(end - payload) / sizeof(T)) {
+        throw std::runtime_error("vector_io: buffer too short");
+    }
+    if (reinterpret_cast<uintptr_t>(payload) % alignof(T) != 0) {
+        throw std::runtime_error("vector_io: payload is misaligned");
+    }
+    cursor = payload + header.count * sizeof(T);
+    return VectorView<T>(reinterpret_cast<const T*>(payload), header.count);
+}
+
+// Views a serialized vector of flat vectors.
+template <typename T>
+Vector<VectorView<T>> ViewNestedVector(const char *&cursor, const char *end) {
+    VectorIoHeader header;
+    if (static_cast<size_t>(end - cursor) < sizeof(header)) {
+        throw std::runtime_error("vector_io: buffer too short");
+    }
+    std::memcpy(&header, cursor, sizeof(header));
+    vector_io::Check(header, 0);
+    cursor += sizeof(header);
+    Vector<VectorView<T>> views;
+    views.reserve(header.count);
+    for (size_t i = 0; i < header.count; ++i) {
+        views.push_back(ViewVector<T>(cursor, end));
+    }
+    return views;
+}
+
+// Streams a sequence too large to hold in memory as chunks of up to
+// chunk_size elements, each framed like a flat vector, and an empty chunk at
+// the end.
+template <typename T>
+class VectorStreamWriter {
+public:
+    explicit VectorStreamWriter(int fd, size_t chunk_size = (1 << 20) / sizeof(T) + 1)
+        : fd_(fd), chunk_size_(chunk_size) {
+        vector_io::CheckLeaf<T>();
+        buffer_.reserve(chunk_size_);
+    }
+
+    VectorStreamWriter(const VectorStreamWriter&) = delete;
+    VectorStreamWriter& operator=(const VectorStreamWriter&) = delete;
+
+    void Append(const T &value) {
+        buffer_.push_back(value);
+        if (buffer_.size() == chunk_size_) {
+            Flush();
+        }
+    }
+
+    // Whole chunks of a large block go out in place; the buffer is topped up
+    // to a chunk first and the remainder buffered, so no chunk written is
+    // larger than chunk_size elements.
+    void Append(const T *data, size_t count) {
+        if (buffer_.size() + count < chunk_size_) {
+            buffer_.append_range(data, data + count);
+            return;
+        }
+        if (buffer_.size() != 0) {
+            size_t fill = chunk_size_ - buffer_.size();
+            buffer_.append_range(data, data + fill);
+            Flush();
+            data += fill;
+            count -= fill;
+        }
+        for (; count >= chunk_size_; data += chunk_size_, count -= chunk_size_) {
+            WriteChunk(data, chunk_size_);
+        }
+        buffer_.append_range(data, data + count);
+    }
+
+    void Flush() {
+        if (buffer_.size() != 0) {
+            WriteChunk(buffer_.begin(), buffer_.size());
+            buffer_.clear();
+        }
+    }
+
+    void Finish() {
+        Flush();
+        WriteChunk(nullptr, 0);
+    }
+
+private:
+    void WriteChunk(const T *data, size_t count) {
+        VectorIoHeader header{count, sizeof(T)};
+        iovec iov[2] = {{&header, sizeof(header)},
+                        {const_cast<T*>(data), count * sizeof(T)}};
+        vector_io::WriteAll(fd_, iov, count != 0 ? 2 : 1);
+    }
+
+    int fd_;
+    size_t chunk_size_;
+    Vector<T> buffer_;
+};
+
+template <typename T>
+class VectorStreamReader {
+public:
+    explicit VectorStreamReader(int fd) : fd_(fd) {
+        vector_io::CheckLeaf<T>();
+    }
+
+    // Replaces chunk with the next chunk; false once the stream has ended.
+    bool Next(Vector<T> &chunk) {
+        if (done_) {
+            return false;
+        }
+        VectorIoHeader header;
+        vector_io::ReadAll(fd_, &header, sizeof(header));
+        vector_io::Check(header, sizeof(T));
+        if (header.count == 0) {
+            done_ = true;
+            return false;
+        }
+        chunk.resize_for_overwrite(header.count);
+        vector_io::ReadAll(fd_, chunk.begin(), header.count * sizeof(T));
+        return true;
+    }
+
+private:
+    int fd_;
+    bool done_ = false;
+};
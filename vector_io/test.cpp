@@ -0,0 +1,92 @@
+#include "../vector_io.h"
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <fcntl.h>
+#include <numeric>
+
+namespace {
+
+// An unlinked scratch file, rewound for reading.
+struct ScratchFile {
+    int fd;
+
+    ScratchFile() {
+        char name[] = "/tmp/vector_io_testXXXXXX";
+        fd = mkstemp(name);
+        unlink(name);
+    }
+
+    ~ScratchFile() {
+        close(fd);
+    }
+
+    void Rewind() {
+        lseek(fd, 0, SEEK_SET);
+    }
+};
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Whole vectors") {
+    ScratchFile file;
+    Vector<int> flat;
+    for (int i = 0; i < 1000; ++i) {
+        flat.push_back(i * i);
+    }
+    Vector<Vector<double>> nested(3);
+    nested[0].push_back(1.5);
+    nested[2].push_back(-2.5);
+    nested[2].push_back(4);
+
+    WriteVector(file.fd, flat);
+    WriteVector(file.fd, nested);
+    file.Rewind();
+
+    Vector<int> flat_read = ReadVector<Vector<int>>(file.fd);
+    REQUIRE(flat_read.size() == 1000);
+    REQUIRE(flat_read[999] == 999 * 999);
+    Vector<Vector<double>> nested_read = ReadVector<Vector<Vector<double>>>(file.fd);
+    REQUIRE(nested_read.size() == 3);
+    REQUIRE(nested_read[1].size() == 0);
+    REQUIRE(nested_read[2][1] == 4);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Streams are cut into chunks") {
+    ScratchFile file;
+    constexpr size_t kChunk = 100;
+    Vector<int> all(5000);
+    std::iota(all.begin(), all.end(), 0);
+    {
+        VectorStreamWriter<int> writer(file.fd, kChunk);
+        size_t at = 0;
+        // Single elements, blocks below, at and far above the chunk size.
+        for (size_t block : {size_t(1), size_t(37), size_t(100), size_t(1234), size_t(63),
+                             size_t(2500), size_t(0)}) {
+            if (block == 1) {
+                writer.Append(all[at]);
+            } else {
+                writer.Append(all.begin() + at, block);
+            }
+            at += block;
+        }
+        writer.Append(all.begin() + at, all.size() - at);
+        writer.Finish();
+    }
+    file.Rewind();
+
+    VectorStreamReader<int> reader(file.fd);
+    Vector<int> chunk;
+    Vector<int> read;
+    while (reader.Next(chunk)) {
+        REQUIRE(chunk.size() <= kChunk);
+        read.append_range(chunk.begin(), chunk.end());
+    }
+    REQUIRE(read.size() == all.size());
+    REQUIRE(std::equal(read.begin(), read.end(), all.begin()));
+}
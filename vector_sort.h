@@ -0,0 +1,295 @@
+#pragma once
+
+#include "Vector.cpp"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+// Sorting for Vector storage. parallel_sort sorts one run per pool thread and
+// merges the runs pairwise, every merge round split evenly across the pool.
+// radix_sort is an LSD byte-wise sort for arithmetic keys, either the
+// elements themselves or a key pulled out of each element.
+namespace vector_sort {
+
+namespace detail {
+
+// Below this many elements a single std::sort wins.
+inline constexpr size_t kParallelMin = 1 << 16;
+
+// Uninitialized scratch storage for n elements. For elements that are not
+// trivially copyable, the first pass writing into it must construct every
+// slot, since the destructor destroys all n.
+template <typename T>
+class Buffer {
+    T *data_;
+    size_t size_;
+
+public:
+    explicit Buffer(size_t n) : data_(std::allocator<T>().allocate(n)), size_(n) {
+    }
+
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+
+    ~Buffer() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            std::destroy_n(data_, size_);
+        }
+        std::allocator<T>().deallocate(data_, size_);
+    }
+
+    T* data() const {
+        return data_;
+    }
+};
+
+// std::merge moving its inputs, constructing the output in place when it is
+// uninitialized storage.
+template <bool Construct, typename T, typename Compare>
+void MergeMove(T *a, T *a_end, T *b, T *b_end, T *out, Compare &less) {
+    auto put = [&out](T &value) {
+        if constexpr (Construct) {
+            new (out) T(std::move(value));
+        } else {
+            *out = std::move(value);
+        }
+        ++out;
+    };
+    while (a != a_end && b != b_end) {
+        put(less(*b, *a) ? *b++ : *a++);
+    }
+    while (a != a_end) {
+        put(*a++);
+    }
+    while (b != b_end) {
+        put(*b++);
+    }
+}
+
+// Number of elements taken from a in the first diagonal elements of
+// merge(a, b), with ties going to a as std::merge does.
+template <typename T, typename Compare>
+size_t MergeSplit(const T *a, size_t na, const T *b, size_t nb, size_t diagonal, Compare &less) {
+    size_t lo = diagonal > nb ? diagonal - nb : 0;
+    size_t hi = diagonal < na ? diagonal : na;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (less(b[diagonal - mid - 1], a[mid])) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+// Merges runs 2i and 2i+1 of from into to; bounds holds runs + 1 offsets.
+// With Construct the slots of to are uninitialized and get constructed.
+// Output positions are cut into pieces of kParallelMin spread across the
+// pool, and each piece finds its inputs by binary search, so late rounds with
+// few runs still use every thread. Every search runs before any element is
+// moved, since a moved-from element no longer compares like the original.
+template <bool Construct, typename T, typename Compare>
+void MergeRound(T *from, T *to, const Vector<size_t> &bounds, Compare &less) {
+    size_t runs = bounds.size() - 1;
+    size_t n = bounds[runs];
+    size_t pieces = (n + kParallelMin - 1) / kParallelMin;
+    ThreadPool &pool = ThreadPool::Global();
+
+    // splits[p] is the number of elements taken from the first run of the
+    // pair holding output position p * kParallelMin.
+    Vector<size_t> splits(pieces + 1);
+    pool.ParallelFor(pieces + 1, 1, [&](size_t begin, size_t end) {
+        for (size_t p = begin; p < end; ++p) {
+            size_t position = std::min(p * kParallelMin, n);
+            size_t r = 0;
+            while (r + 2 < runs && bounds[r + 2] <= position) {
+                r += 2;
+            }
+            size_t start = bounds[r];
+            size_t middle = bounds[r + 1];
+            size_t stop = r + 2 <= runs ? bounds[r + 2] : middle;
+            splits[p] = MergeSplit(from + start, middle - start, from + middle, stop - middle,
+                                   position - start, less);
+        }
+    });
+
+    pool.ParallelFor(pieces, 1, [&](size_t piece_begin, size_t piece_end) {
+        for (size_t p = piece_begin; p < piece_end; ++p) {
+            size_t begin = p * kParallelMin;
+            size_t end = std::min(begin + kParallelMin, n);
+            for (size_t r = 0; r < runs; r += 2) {
+                size_t start = bounds[r];
+                size_t middle = bounds[r + 1];
+                size_t stop = r + 2 <= runs ? bounds[r + 2] : middle;
+                if (stop <= begin || start >= end) {
+                    continue;
+                }
+                size_t first = std::max(begin, start) - start;
+                size_t last = std::min(end, stop) - start;
+                size_t i0 = begin >= start ? splits[p] : 0;
+                size_t i1 = end < stop ? splits[p + 1] : middle - start;
+                MergeMove<Construct>(from + start + i0, from + start + i1,
+                                     from + middle + first - i0, from + middle + last - i1,
+                                     to + start + first, less);
+            }
+        }
+    });
+}
+
+// Maps a key to an unsigned integer with the same order.
+template <typename Key>
+auto OrderedBits(Key key) {
+    static_assert(std::is_arithmetic_v<Key> && !std::is_same_v<Key, bool>,
+                  "radix_sort needs integral or floating keys");
+    if constexpr (std::is_floating_point_v<Key>) {
+        static_assert(sizeof(Key) == 4 || sizeof(Key) == 8);
+        using Bits = std::conditional_t<sizeof(Key) == 4, uint32_t, uint64_t>;
+        Bits bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        constexpr Bits kSign = Bits(1) << (sizeof(Bits) * 8 - 1);
+        // Negative values have every bit flipped, positive ones just the sign.
+        return Bits(bits ^ (Bits(0 - (bits >> (sizeof(Bits) * 8 - 1))) | kSign));
+    } else {
+        using Bits = std::make_unsigned_t<Key>;
+        if constexpr (std::is_signed_v<Key>) {
+            return Bits(Bits(key) ^ (Bits(1) << (sizeof(Bits) * 8 - 1)));
+        } else {
+            return Bits(key);
+        }
+    }
+}
+
+}  // namespace detail
+
+// Unstable sort of [first, last). less must not throw, and T must be nothrow
+// movable.
+template <typename T, typename Compare = std::less<>>
+void parallel_sort(T *first, T *last, Compare less = Compare()) {
+    static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>);
+    size_t n = last - first;
+    ThreadPool &pool = ThreadPool::Global();
+    size_t runs = std::min(pool.Size() + 1, n / detail::kParallelMin);
+    if (runs <= 1) {
+        std::sort(first, last, less);
+        return;
+    }
+
+    Vector<size_t> bounds;
+    for (size_t i = 0; i < runs; ++i) {
+        bounds.push_back(n / runs * i);
+    }
+    bounds.push_back(n);
+    pool.ParallelFor(runs, 1, [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r) {
+            std::sort(first + bounds[r], first + bounds[r + 1], less);
+        }
+    });
+
+    // The first round moves the elements out into the buffer, constructing
+    // every slot of it; later rounds assign between the two.
+    detail::Buffer<T> buffer(n);
+    T *from = first;
+    T *to = buffer.data();
+    bool constructed = std::is_trivially_copyable_v<T>;
+    while (bounds.size() > 2) {
+        if (constructed) {
+            detail::MergeRound<false>(from, to, bounds, less);
+        } else {
+            detail::MergeRound<true>(from, to, bounds, less);
+            constructed = true;
+        }
+        Vector<size_t> merged;
+        for (size_t i = 0; i < bounds.size(); i += 2) {
+            merged.push_back(bounds[i]);
+        }
+        if (merged[merged.size() - 1] != n) {
+            merged.push_back(n);
+        }
+        bounds.swap(merged);
+        std::swap(from, to);
+    }
+    if (from != first) {
+        pool.ParallelFor(n, detail::kParallelMin, [from, first](size_t begin, size_t end) {
+            std::move(from + begin, from + end, first + begin);
+        });
+    }
+}
+
+template <typename T, typename Alloc, typename Growth, typename Compare = std::less<>>
+void parallel_sort(Vector<T, Alloc, Growth> &vector, Compare less = Compare()) {
+    parallel_sort(vector.begin(), vector.end(), less);
+}
+
+// Stable LSD radix sort by key(element), one pass per key byte. Passes where
+// every key has the same byte are skipped, so small values in wide types cost
+// little. Floating keys order like operator<, with -0.0 before 0.0 and NaNs
+// at the ends by sign.
+template <typename T, typename KeyFn>
+void radix_sort(T *first, T *last, KeyFn key) {
+    static_assert(std::is_trivially_copyable_v<T>, "radix_sort moves elements as raw bytes");
+    using Key = std::decay_t<std::invoke_result_t<KeyFn&, const T&>>;
+    using Bits = decltype(detail::OrderedBits(Key()));
+    constexpr size_t kPasses = sizeof(Bits);
+    size_t n = last - first;
+    if (n < 2) {
+        return;
+    }
+
+    // Histograms for every byte in one read of the input.
+    auto counts = std::make_unique<size_t[]>(kPasses * 256);
+    for (size_t i = 0; i < n; ++i) {
+        Bits bits = detail::OrderedBits(Key(key(first[i])));
+        for (size_t pass = 0; pass < kPasses; ++pass) {
+            ++counts[pass * 256 + ((bits >> (pass * 8)) & 0xff)];
+        }
+    }
+
+    detail::Buffer<T> buffer(n);
+    T *from = first;
+    T *to = buffer.data();
+    for (size_t pass = 0; pass < kPasses; ++pass) {
+        size_t *count = &counts[pass * 256];
+        Bits sample = detail::OrderedBits(Key(key(first[0])));
+        if (count[(sample >> (pass * 8)) & 0xff] == n) {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t byte = 0; byte < 256; ++byte) {
+            size_t here = count[byte];
+            count[byte] = offset;
+            offset += here;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            Bits bits = detail::OrderedBits(Key(key(from[i])));
+            to[count[(bits >> (pass * 8)) & 0xff]++] = from[i];
+        }
+        std::swap(from, to);
+    }
+    if (from != first) {
+        std::memcpy(static_cast<void*>(first), from, n * sizeof(T));
+    }
+}
+
+template <typename T>
+void radix_sort(T *first, T *last) {
+    radix_sort(first, last, [](const T &value) { return value; });
+}
+
+template <typename T, typename Alloc, typename Growth, typename KeyFn>
+void radix_sort(Vector<T, Alloc, Growth> &vector, KeyFn key) {
+    radix_sort(vector.begin(), vector.end(), key);
+}
+
+template <typename T, typename Alloc, typename Growth>
+void radix_sort(Vector<T, Alloc, Growth> &vector) {
+    radix_sort(vector.begin(), vector.end());
+}
+
+}  // namespace vector_sort
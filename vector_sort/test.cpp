@@ -0,0 +1,94 @@
+#include "../vector_sort.h"
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Parallel sort") {
+    std::mt19937 gen(7);
+
+    SECTION("Small input") {
+        Vector<int> values;
+        for (int i = 0; i < 1000; ++i) {
+            values.push_back(gen() % 100);
+        }
+        std::vector<int> expected(values.begin(), values.end());
+        std::sort(expected.begin(), expected.end());
+        vector_sort::parallel_sort(values);
+        REQUIRE(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+    }
+
+    SECTION("Integers") {
+        Vector<int> values;
+        for (int i = 0; i < 1000003; ++i) {
+            values.push_back(static_cast<int>(gen()));
+        }
+        std::vector<int> expected(values.begin(), values.end());
+        std::sort(expected.begin(), expected.end(), std::greater<>());
+        vector_sort::parallel_sort(values, std::greater<>());
+        REQUIRE(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+    }
+
+    SECTION("Strings") {
+        Vector<std::string> values;
+        for (int i = 0; i < 300000; ++i) {
+            values.push_back(std::to_string(gen()) + std::string(gen() % 32, 'x'));
+        }
+        std::vector<std::string> expected(values.begin(), values.end());
+        std::sort(expected.begin(), expected.end());
+        vector_sort::parallel_sort(values);
+        REQUIRE(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Radix sort") {
+    std::mt19937_64 gen(11);
+
+    SECTION("Signed integers") {
+        Vector<int64_t> values;
+        for (int i = 0; i < 100000; ++i) {
+            values.push_back(static_cast<int64_t>(gen()) >> (gen() % 64));
+        }
+        std::vector<int64_t> expected(values.begin(), values.end());
+        std::sort(expected.begin(), expected.end());
+        vector_sort::radix_sort(values);
+        REQUIRE(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+    }
+
+    SECTION("Doubles") {
+        Vector<double> values;
+        std::normal_distribution<double> normal(0, 1000);
+        for (int i = 0; i < 100000; ++i) {
+            values.push_back(normal(gen));
+        }
+        std::vector<double> expected(values.begin(), values.end());
+        std::sort(expected.begin(), expected.end());
+        vector_sort::radix_sort(values);
+        REQUIRE(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+    }
+
+    SECTION("Stable by key") {
+        struct Item {
+            uint16_t key;
+            int order;
+        };
+        Vector<Item> values;
+        for (int i = 0; i < 50000; ++i) {
+            values.push_back({static_cast<uint16_t>(gen() % 300), i});
+        }
+        vector_sort::radix_sort(values, [](const Item &item) { return item.key; });
+        for (size_t i = 1; i < values.size(); ++i) {
+            REQUIRE(values[i - 1].key <= values[i].key);
+            if (values[i - 1].key == values[i].key) {
+                REQUIRE(values[i - 1].order < values[i].order);
+            }
+        }
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <typeinfo>
+
+// Opt-in memory accounting for VectorMemory and Vector, enabled by compiling
+// with -DVECTOR_STATS. Without it every hook is an empty inline function.
+//
+// Counters are kept per element type and are process-wide:
+//   live      bytes of storage currently allocated
+//   used      bytes of it holding elements (size * sizeof(T))
+//   slack     live - used
+//   allocs    blocks allocated
+//   reallocs  growths and shrinks of an existing block
+//   moved     bytes relocated by those, 0 when the allocator resized in place
+struct VectorTypeStats {
+    const char *name;
+    size_t element_size;
+    std::atomic<int64_t> live_bytes{0};
+    std::atomic<int64_t> used_bytes{0};
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> reallocations{0};
+    std::atomic<uint64_t> bytes_moved{0};
+    VectorTypeStats *next = nullptr;
+
+    VectorTypeStats(const char *name, size_t element_size)
+        : name(name), element_size(element_size) {
+    }
+};
+
+class VectorStats {
+public:
+#ifdef VECTOR_STATS
+    static constexpr bool kEnabled = true;
+#else
+    static constexpr bool kEnabled = false;
+#endif
+
+    template <typename T>
+    static VectorTypeStats& Get() {
+        static VectorTypeStats* stats = Register(new VectorTypeStats(typeid(T).name(), sizeof(T)));
+        return *stats;
+    }
+
+    template <typename T>
+    static void OnAllocate(size_t capacity) {
+        if constexpr (kEnabled) {
+            Get<T>().live_bytes.fetch_add(capacity * sizeof(T), std::memory_order_relaxed);
+            Get<T>().allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T>
+    static void OnFree(size_t capacity) {
+        if constexpr (kEnabled) {
+            Get<T>().live_bytes.fetch_sub(capacity * sizeof(T), std::memory_order_relaxed);
+        }
+    }
+
+    // A block resized in place by the allocator.
+    template <typename T>
+    static void OnResizeBlock(size_t old_capacity, size_t new_capacity) {
+        if constexpr (kEnabled) {
+            Get<T>().live_bytes.fetch_add(
+                (int64_t(new_capacity) - int64_t(old_capacity)) * int64_t(sizeof(T)),
+                std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T>
+    static void OnReallocate(size_t moved) {
+        if constexpr (kEnabled) {
+            Get<T>().reallocations.fetch_add(1, std::memory_order_relaxed);
+            Get<T>().bytes_moved.fetch_add(moved * sizeof(T), std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T>
+    static void OnResize(size_t old_size, size_t new_size) {
+        if constexpr (kEnabled) {
+            Get<T>().used_bytes.fetch_add(
+                (int64_t(new_size) - int64_t(old_size)) * int64_t(sizeof(T)),
+                std::memory_order_relaxed);
+        }
+    }
+
+    // One line per element type seen so far.
+    static void Report(std::ostream &out) {
+        out << "type\telement\tlive\tused\tslack\tallocs\treallocs\tmoved\n";
+        for (VectorTypeStats *stats = Head().load(std::memory_order_acquire); stats != nullptr;
+             stats = stats->next) {
+            int64_t live = stats->live_bytes.load(std::memory_order_relaxed);
+            int64_t used = stats->used_bytes.load(std::memory_order_relaxed);
+            out << stats->name << '\t' << stats->element_size << '\t' << live << '\t' << used
+                << '\t' << live - used << '\t'
+                << stats->allocations.load(std::memory_order_relaxed) << '\t'
+                << stats->reallocations.load(std::memory_order_relaxed) << '\t'
+                << stats->bytes_moved.load(std::memory_order_relaxed) << '\n';
+        }
+    }
+
+private:
+    static std::atomic<VectorTypeStats*>& Head() {
+        static std::atomic<VectorTypeStats*> head{nullptr};
+        return head;
+    }
+
+    static VectorTypeStats* Register(VectorTypeStats *stats) {
+        stats->next = Head().load(std::memory_order_relaxed);
+        while (!Head().compare_exchange_weak(stats->next, stats, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+        }
+        return stats;
+    }
+};